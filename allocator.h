@@ -0,0 +1,38 @@
+#ifndef _ALLOCATOR_H
+#define _ALLOCATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// An allocator context: a malloc()/free() pair plus an opaque state
+// pointer that is handed back on every call.
+//
+// linked_list_create_with_allocator() and queue_create_with_allocator()
+// copy the context into the instance they create, and every allocation
+// made on behalf of that instance (the instance itself, its nodes or
+// chunks, iterators) goes through it. Instances created the old way,
+// with linked_list_create() or queue_create(), use a default context
+// that forwards to whatever was passed to the *_register_malloc() and
+// *_register_free() functions.
+//
+// A context is only ever called from operations on the instances that
+// hold it, so a context that is private to one thread needs no locking.
+// The state must outlive every instance created with it.
+//
+struct allocator {
+    // Returns size bytes of memory, or NULL on failure.
+    void * (*alloc)(void * state, size_t size);
+    // Releases memory returned by alloc. Never called with NULL.
+    void   (*free)(void * state, void * addr);
+    void * state;
+};
+
+// Returns TRUE when a and b are the same context, i.e. memory allocated
+// through one may be freed through the other. Storage can only change
+// hands between instances whose contexts are the same.
+//
+static inline bool allocator_equal(const struct allocator * a, const struct allocator * b){
+    return a->alloc == b->alloc && a->free == b->free && a->state == b->state;
+}
+
+#endif
@@ -0,0 +1,372 @@
+/*
+*MIT License
+*
+*Copyright (c) 2025 Siddhant Nadkarni
+*
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*/
+
+
+
+#include <string.h>
+
+#include "arena_list.h"
+
+// Function pointers to (potentially) custom malloc() and
+// free() functions.
+//
+static void * (*malloc_fptr)(size_t size) = NULL;
+static void   (*free_fptr)(void* addr)    = NULL;
+
+// Moves the node array to a new allocation of the given capacity.
+// \param al       : Pointer to arena_list.
+// \param capacity : New capacity in nodes, at least al->used.
+// Returns TRUE on success, FALSE otherwise. The list is unchanged on failure.
+//
+static bool arena_list_resize(struct arena_list * al, uint32_t capacity){
+    struct arena_node * nodes = (struct arena_node *)malloc_fptr((size_t)capacity * sizeof(struct arena_node));
+    if(nodes == NULL){
+        return false;
+    }
+    //links are indices, so the nodes can simply be copied over
+    if(al->nodes != NULL){
+        memcpy(nodes, al->nodes, (size_t)al->used * sizeof(struct arena_node));
+        free_fptr(al->nodes);
+    }
+    al->nodes    = nodes;
+    al->capacity = capacity;
+    return true;
+}
+
+// Takes a node from the free list, or failing that from the unused
+// end of the node array, doubling the array if it is full.
+// \param al : Pointer to arena_list.
+// Returns the index of the node on success, ARENA_LIST_NIL on failure.
+//
+static uint32_t arena_node_alloc(struct arena_list * al){
+    uint32_t index = al->free_head;
+    if(index != ARENA_LIST_NIL){
+        al->free_head = al->nodes[index].next;
+        return index;
+    }
+
+    if(al->used == al->capacity){
+        //ARENA_LIST_NIL itself is never a valid index
+        if(al->capacity == ARENA_LIST_NIL){
+            return ARENA_LIST_NIL;
+        }
+        size_t capacity = 2 * (size_t)al->capacity;
+        if(capacity > ARENA_LIST_NIL){
+            capacity = ARENA_LIST_NIL;
+        }
+        if(!arena_list_resize(al, (uint32_t)capacity)){
+            return ARENA_LIST_NIL;
+        }
+    }
+
+    return al->used++;
+}
+
+// Returns a node to the free list.
+// \param al    : Pointer to arena_list.
+// \param index : Index of a node that is no longer linked into the list.
+//
+static void arena_node_free(struct arena_list * al, uint32_t index){
+    if(al->size == 0){
+        //nothing is live, start handing nodes out from the front of the
+        //array again rather than in free list order
+        al->used      = 0;
+        al->free_head = ARENA_LIST_NIL;
+        return;
+    }
+    al->nodes[index].next = al->free_head;
+    al->free_head         = index;
+}
+
+// Returns the index of the node at position index.
+// \param al    : Pointer to arena_list.
+// \param index : Position of the node, less than al->size.
+//
+static uint32_t arena_list_walk(struct arena_list * al, size_t index){
+    uint32_t curr = al->head;
+    for(size_t i = 0; i < index; i++){
+        curr = al->nodes[curr].next;
+    }
+    return curr;
+}
+
+// Creates a new arena_list.
+// Returns a new arena_list on success, NULL on failure.
+//
+struct arena_list * arena_list_create(void){
+    return arena_list_create_with_capacity(ARENA_LIST_MIN_CAPACITY);
+}
+
+// Creates a new arena_list with room for hint elements.
+// \param hint : Expected maximum number of elements.
+// Returns a new arena_list on success, NULL on failure.
+//
+struct arena_list * arena_list_create_with_capacity(size_t hint){
+    //check if malloc_fptr/free_fptr are NULL or the hint can't be indexed
+    if(malloc_fptr == NULL || free_fptr == NULL || hint > ARENA_LIST_NIL){
+        return NULL;
+    }
+    if(hint < ARENA_LIST_MIN_CAPACITY){
+        hint = ARENA_LIST_MIN_CAPACITY;
+    }
+
+    struct arena_list * al = (struct arena_list *)malloc_fptr(sizeof(struct arena_list));
+    if(al == NULL){
+        return NULL;
+    }
+
+    al->nodes     = NULL;
+    al->capacity  = 0;
+    al->used      = 0;
+    al->free_head = ARENA_LIST_NIL;
+    al->head      = ARENA_LIST_NIL;
+    al->tail      = ARENA_LIST_NIL;
+    al->size      = 0;
+
+    //the hint is the exact size, not rounded, so a known size costs no slack
+    if(!arena_list_resize(al, (uint32_t)hint)){
+        free_fptr(al);
+        return NULL;
+    }
+
+    return al;
+}
+
+// Deletes an arena_list.
+// \param al : Pointer to arena_list to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_delete(struct arena_list * al){
+    if(al == NULL || free_fptr == NULL){
+        return false;
+    }
+
+    //every node lives in the one array
+    free_fptr(al->nodes);
+    free_fptr(al);
+
+    return true;
+}
+
+// Returns the size of an arena_list.
+// \param al : Pointer to arena_list.
+// Returns size on success, SIZE_MAX on failure.
+//
+size_t arena_list_size(struct arena_list * al){
+    if(al == NULL){
+        return SIZE_MAX;
+    }
+    return al->size;
+}
+
+// Returns the number of bytes held by the node array.
+// \param al : Pointer to arena_list.
+// Returns the size of the node array on success, SIZE_MAX on failure.
+//
+size_t arena_list_memory(struct arena_list * al){
+    if(al == NULL){
+        return SIZE_MAX;
+    }
+    return (size_t)al->capacity * sizeof(struct arena_node);
+}
+
+// Inserts an element at the end of the arena_list.
+// \param al   : Pointer to arena_list.
+// \param data : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_insert_end(struct arena_list * al, unsigned int data){
+    if(al == NULL){
+        return false;
+    }
+
+    uint32_t index = arena_node_alloc(al);
+    if(index == ARENA_LIST_NIL){
+        return false;
+    }
+    al->nodes[index].next = ARENA_LIST_NIL;
+    al->nodes[index].data = data;
+
+    if(al->tail == ARENA_LIST_NIL){
+        al->head = index;
+    }
+    else{
+        al->nodes[al->tail].next = index;
+    }
+    al->tail = index;
+    al->size++;
+
+    return true;
+}
+
+// Inserts an element at the front of the arena_list.
+// \param al   : Pointer to arena_list.
+// \param data : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_insert_front(struct arena_list * al, unsigned int data){
+    if(al == NULL){
+        return false;
+    }
+
+    uint32_t index = arena_node_alloc(al);
+    if(index == ARENA_LIST_NIL){
+        return false;
+    }
+    al->nodes[index].next = al->head;
+    al->nodes[index].data = data;
+
+    al->head = index;
+    if(al->tail == ARENA_LIST_NIL){
+        al->tail = index;
+    }
+    al->size++;
+
+    return true;
+}
+
+// Inserts an element at a specified index in the arena_list.
+// \param al    : Pointer to arena_list.
+// \param index : Index to insert data at.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_insert(struct arena_list * al, size_t index, unsigned int data){
+    if(al == NULL || index > al->size){
+        return false;
+    }
+    if(index == 0){
+        return arena_list_insert_front(al, data);
+    }
+    if(index == al->size){
+        return arena_list_insert_end(al, data);
+    }
+
+    uint32_t node = arena_node_alloc(al);
+    if(node == ARENA_LIST_NIL){
+        return false;
+    }
+
+    //link in after the element at index - 1
+    uint32_t prev = arena_list_walk(al, index - 1);
+    al->nodes[node].data = data;
+    al->nodes[node].next = al->nodes[prev].next;
+    al->nodes[prev].next = node;
+    al->size++;
+
+    return true;
+}
+
+// Finds the first occurrence of data and returns its index.
+// \param al   : Pointer to arena_list.
+// \param data : Data to find.
+// Returns index of the first element with that data, SIZE_MAX otherwise.
+//
+size_t arena_list_find(struct arena_list * al, unsigned int data){
+    if(al == NULL){
+        return SIZE_MAX;
+    }
+
+    size_t position = 0;
+    for(uint32_t curr = al->head; curr != ARENA_LIST_NIL; curr = al->nodes[curr].next){
+        if(al->nodes[curr].data == data){
+            return position;
+        }
+        position++;
+    }
+
+    return SIZE_MAX;
+}
+
+// Removes the element at a specific index.
+// \param al    : Pointer to arena_list.
+// \param index : Index of the element to remove.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_remove(struct arena_list * al, size_t index){
+    if(al == NULL || index >= al->size){
+        return false;
+    }
+    if(index == 0){
+        unsigned int data;
+        return arena_list_remove_front(al, &data);
+    }
+
+    uint32_t prev = arena_list_walk(al, index - 1);
+    uint32_t node = al->nodes[prev].next;
+    al->nodes[prev].next = al->nodes[node].next;
+    if(node == al->tail){
+        al->tail = prev;
+    }
+    al->size--;
+    arena_node_free(al, node);
+
+    return true;
+}
+
+// Removes the first element, copying its data out.
+// \param al   : Pointer to arena_list.
+// \param data : Pointer to removed data (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_remove_front(struct arena_list * al, unsigned int * data){
+    if(al == NULL || data == NULL || al->size == 0){
+        return false;
+    }
+
+    uint32_t node = al->head;
+    *data    = al->nodes[node].data;
+    al->head = al->nodes[node].next;
+    if(al->head == ARENA_LIST_NIL){
+        al->tail = ARENA_LIST_NIL;
+    }
+    al->size--;
+    arena_node_free(al, node);
+
+    return true;
+}
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_register_malloc(void * (*malloc)(size_t)){
+    if(malloc == NULL){
+        return false;
+    }
+    malloc_fptr = malloc;
+    return true;
+}
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_register_free(void (*free)(void*)){
+    if(free == NULL){
+        return false;
+    }
+    free_fptr = free;
+    return true;
+}
@@ -0,0 +1,138 @@
+#ifndef _ARENA_LIST_H
+#define _ARENA_LIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Index value that stands in for a NULL link.
+//
+#define ARENA_LIST_NIL UINT32_MAX
+
+// Smallest node array an arena_list allocates, in nodes.
+//
+#define ARENA_LIST_MIN_CAPACITY 64
+
+// A node of an arena_list. Links are 32-bit indices into the list's
+// node array rather than pointers, so a node is 8 bytes instead of the
+// 16 (a pointer plus a padded unsigned int) of struct node on a 64-bit
+// machine.
+//
+struct arena_node {
+    uint32_t next;
+    unsigned int data;
+};
+
+// Singly linked list of unsigned ints whose nodes all live in one
+// contiguous array.
+//
+// nodes[0 .. used) have been handed out at some point; removed nodes
+// are kept on a free list threaded through next, starting at
+// free_head, and are reused before the array is extended. When the
+// array is full it is doubled, which only needs a copy: indices stay
+// valid wherever the array ends up. For the same reason the array is
+// position independent and could equally be backed by a single mmap()
+// region or written to disk as is.
+//
+// At most ARENA_LIST_NIL - 1 nodes can be live at once.
+//
+struct arena_list {
+    struct arena_node * nodes;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t free_head;
+    uint32_t head;
+    uint32_t tail;
+    size_t size;
+};
+
+// Creates a new, empty arena_list.
+// PRECONDITION: Register malloc() and free() functions via the
+//               arena_list_register_malloc() and
+//               arena_list_register_free() functions.
+// Returns a new arena_list on success, NULL on failure.
+//
+struct arena_list * arena_list_create(void);
+
+// Creates a new, empty arena_list whose node array is sized up front
+// so that inserts don't allocate until the hint is exceeded.
+// \param hint : Expected maximum number of elements.
+// Returns a new arena_list on success, NULL on failure.
+//
+struct arena_list * arena_list_create_with_capacity(size_t hint);
+
+// Deletes an arena_list and its node array.
+// \param al : Pointer to arena_list to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_delete(struct arena_list * al);
+
+// Returns the number of elements in an arena_list.
+// \param al : Pointer to arena_list.
+// Returns size on success, SIZE_MAX on failure.
+//
+size_t arena_list_size(struct arena_list * al);
+
+// Returns the number of bytes held by the node array of an arena_list.
+// \param al : Pointer to arena_list.
+// Returns the size of the node array on success, SIZE_MAX on failure.
+//
+size_t arena_list_memory(struct arena_list * al);
+
+// Inserts an element at the end of the arena_list.
+// \param al   : Pointer to arena_list.
+// \param data : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_insert_end(struct arena_list * al, unsigned int data);
+
+// Inserts an element at the front of the arena_list.
+// \param al   : Pointer to arena_list.
+// \param data : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_insert_front(struct arena_list * al, unsigned int data);
+
+// Inserts an element at a specified index in the arena_list.
+// \param al    : Pointer to arena_list.
+// \param index : Index to insert data at.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_insert(struct arena_list * al, size_t index, unsigned int data);
+
+// Finds the first occurrence of data and returns its index.
+// \param al   : Pointer to arena_list.
+// \param data : Data to find.
+// Returns index of the first element with that data, SIZE_MAX otherwise.
+//
+size_t arena_list_find(struct arena_list * al, unsigned int data);
+
+// Removes the element at a specific index.
+// \param al    : Pointer to arena_list.
+// \param index : Index of the element to remove.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_remove(struct arena_list * al, size_t index);
+
+// Removes the first element, copying its data out. Together with
+// arena_list_insert_end() this makes the arena_list a FIFO queue.
+// \param al   : Pointer to arena_list.
+// \param data : Pointer to removed data (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_remove_front(struct arena_list * al, unsigned int * data);
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_register_malloc(void * (*malloc)(size_t));
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool arena_list_register_free(void (*free)(void*));
+
+#endif
@@ -0,0 +1,351 @@
+/*
+*MIT License
+*
+*Copyright (c) 2025 Siddhant Nadkarni
+*
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*/
+
+
+
+#include "deque.h"
+
+// Function pointers to (potentially) custom malloc() and
+// free() functions.
+//
+static void * (*malloc_fptr)(size_t size) = NULL;
+static void   (*free_fptr)(void* addr)    = NULL;
+
+// Index both ends start from in a fresh or emptied block, leaving the
+// same room for pushes at the front as at the back.
+//
+#define DEQUE_BLOCK_MIDDLE (DEQUE_BLOCK_CAPACITY / 2)
+
+// Grabs an unlinked block, preferring the spare over a fresh allocation.
+// \param deque : Pointer to deque.
+// Returns a block on success, NULL on allocation failure.
+//
+static struct deque_block * deque_block_acquire(struct deque * deque){
+    struct deque_block * block = deque->spare;
+    if(block != NULL){
+        deque->spare = NULL;
+    }
+    else{
+        block = (struct deque_block *)malloc_fptr(sizeof(struct deque_block));
+        if(block == NULL){
+            return NULL;
+        }
+    }
+    block->prev = NULL;
+    block->next = NULL;
+    return block;
+}
+
+// Keeps a block that was just unlinked as the spare, or frees it if
+// there already is one.
+// \param deque : Pointer to deque.
+// \param block : Block that is no longer linked into the deque.
+//
+static void deque_block_release(struct deque * deque, struct deque_block * block){
+    if(deque->spare == NULL){
+        deque->spare = block;
+    }
+    else{
+        free_fptr(block);
+    }
+}
+
+// Links the first block into a deque that owns none.
+// \param deque : Pointer to deque with head == NULL.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool deque_first_block(struct deque * deque){
+    struct deque_block * block = deque_block_acquire(deque);
+    if(block == NULL){
+        return false;
+    }
+    deque->head       = block;
+    deque->tail       = block;
+    deque->head_index = DEQUE_BLOCK_MIDDLE;
+    deque->tail_index = DEQUE_BLOCK_MIDDLE;
+    return true;
+}
+
+// Creates a new deque.
+// Returns a new deque on success, NULL on failure.
+//
+struct deque * deque_create(void){
+    //check if malloc_fptr/free_fptr are NULL
+    if(malloc_fptr == NULL || free_fptr == NULL){
+        return NULL;
+    }
+
+    struct deque * deque = (struct deque *)malloc_fptr(sizeof(struct deque));
+    if(deque == NULL){
+        return NULL;
+    }
+
+    //blocks are allocated lazily on the first push
+    deque->size       = 0;
+    deque->head       = NULL;
+    deque->tail       = NULL;
+    deque->head_index = 0;
+    deque->tail_index = 0;
+    deque->spare      = NULL;
+
+    return deque;
+}
+
+// Deletes a deque.
+// \param deque : Pointer to deque to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_delete(struct deque * deque){
+    if(deque == NULL){
+        return false;
+    }
+
+    struct deque_block * curr = deque->head;
+    while(curr != NULL){
+        struct deque_block * next = curr->next;
+        free_fptr(curr);
+        curr = next;
+    }
+    if(deque->spare != NULL){
+        free_fptr(deque->spare);
+    }
+    free_fptr(deque);
+
+    return true;
+}
+
+// Pushes an unsigned int onto the front of the deque.
+// \param deque : Pointer to deque.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_push_front(struct deque * deque, unsigned int data){
+    if(deque == NULL){
+        return false;
+    }
+
+    if(deque->head == NULL){
+        if(!deque_first_block(deque)){
+            return false;
+        }
+    }
+    else if(deque->head_index == 0){
+        //front block is full, link a new one in before it
+        struct deque_block * block = deque_block_acquire(deque);
+        if(block == NULL){
+            return false;
+        }
+        block->next       = deque->head;
+        deque->head->prev = block;
+        deque->head       = block;
+        deque->head_index = DEQUE_BLOCK_CAPACITY;
+    }
+
+    deque->head->data[--deque->head_index] = data;
+    deque->size++;
+
+    return true;
+}
+
+// Pushes an unsigned int onto the back of the deque.
+// \param deque : Pointer to deque.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_push_back(struct deque * deque, unsigned int data){
+    if(deque == NULL){
+        return false;
+    }
+
+    if(deque->tail == NULL){
+        if(!deque_first_block(deque)){
+            return false;
+        }
+    }
+    else if(deque->tail_index == DEQUE_BLOCK_CAPACITY){
+        //back block is full, link a new one in after it
+        struct deque_block * block = deque_block_acquire(deque);
+        if(block == NULL){
+            return false;
+        }
+        block->prev       = deque->tail;
+        deque->tail->next = block;
+        deque->tail       = block;
+        deque->tail_index = 0;
+    }
+
+    deque->tail->data[deque->tail_index++] = data;
+    deque->size++;
+
+    return true;
+}
+
+// Pops an unsigned int from the front of the deque.
+// \param deque       : Pointer to deque.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_pop_front(struct deque * deque, unsigned int * popped_data){
+    if(deque == NULL || deque->size == 0 || popped_data == NULL){
+        return false;
+    }
+
+    *popped_data = deque->head->data[deque->head_index++];
+    deque->size--;
+
+    if(deque->size == 0){
+        //head == tail here, start over from the middle of the block
+        deque->head_index = DEQUE_BLOCK_MIDDLE;
+        deque->tail_index = DEQUE_BLOCK_MIDDLE;
+    }
+    else if(deque->head_index == DEQUE_BLOCK_CAPACITY){
+        //front block drained, move on to the next one
+        struct deque_block * drained = deque->head;
+        deque->head       = drained->next;
+        deque->head->prev = NULL;
+        deque->head_index = 0;
+        deque_block_release(deque, drained);
+    }
+
+    return true;
+}
+
+// Pops an unsigned int from the back of the deque.
+// \param deque       : Pointer to deque.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_pop_back(struct deque * deque, unsigned int * popped_data){
+    if(deque == NULL || deque->size == 0 || popped_data == NULL){
+        return false;
+    }
+
+    *popped_data = deque->tail->data[--deque->tail_index];
+    deque->size--;
+
+    if(deque->size == 0){
+        //head == tail here, start over from the middle of the block
+        deque->head_index = DEQUE_BLOCK_MIDDLE;
+        deque->tail_index = DEQUE_BLOCK_MIDDLE;
+    }
+    else if(deque->tail_index == 0){
+        //back block drained, step back to the previous one
+        struct deque_block * drained = deque->tail;
+        deque->tail       = drained->prev;
+        deque->tail->next = NULL;
+        deque->tail_index = DEQUE_BLOCK_CAPACITY;
+        deque_block_release(deque, drained);
+    }
+
+    return true;
+}
+
+// Returns the front of the deque without removing it.
+// \param deque       : Pointer to deque.
+// \param peeked_data : Pointer to peeked data (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_peek_front(struct deque * deque, unsigned int * peeked_data){
+    if(deque == NULL || deque->size == 0 || peeked_data == NULL){
+        return false;
+    }
+    *peeked_data = deque->head->data[deque->head_index];
+    return true;
+}
+
+// Returns the back of the deque without removing it.
+// \param deque       : Pointer to deque.
+// \param peeked_data : Pointer to peeked data (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_peek_back(struct deque * deque, unsigned int * peeked_data){
+    if(deque == NULL || deque->size == 0 || peeked_data == NULL){
+        return false;
+    }
+    *peeked_data = deque->tail->data[deque->tail_index - 1];
+    return true;
+}
+
+// Empties the deque, keeping one block for reuse.
+// \param deque : Pointer to deque.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_clear(struct deque * deque){
+    if(deque == NULL){
+        return false;
+    }
+    if(deque->head == NULL){
+        return true;
+    }
+
+    //keep the head block, release everything after it
+    struct deque_block * curr = deque->head->next;
+    while(curr != NULL){
+        struct deque_block * next = curr->next;
+        deque_block_release(deque, curr);
+        curr = next;
+    }
+    deque->head->next = NULL;
+    deque->tail       = deque->head;
+    deque->head_index = DEQUE_BLOCK_MIDDLE;
+    deque->tail_index = DEQUE_BLOCK_MIDDLE;
+    deque->size       = 0;
+
+    return true;
+}
+
+// Returns the number of entries in the deque.
+// \param deque : Pointer to deque.
+// Returns size on success, SIZE_MAX on failure.
+//
+size_t deque_size(struct deque * deque){
+    if(deque == NULL){
+        return SIZE_MAX;
+    }
+    return deque->size;
+}
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_register_malloc(void * (*malloc)(size_t)){
+    if(malloc == NULL){
+        return false;
+    }
+    malloc_fptr = malloc;
+    return true;
+}
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_register_free(void (*free)(void*)){
+    if(free == NULL){
+        return false;
+    }
+    free_fptr = free;
+    return true;
+}
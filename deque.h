@@ -0,0 +1,125 @@
+#ifndef _DEQUE_H
+#define _DEQUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Number of entries in a deque block. Picked so that a block, two
+// pointers plus the entries, is exactly 16 KiB on a 64-bit machine.
+//
+#define DEQUE_BLOCK_CAPACITY 4092
+
+// A fixed size block of deque entries. Blocks are linked both ways so
+// the deque can grow and shrink at either end.
+//
+struct deque_block {
+    struct deque_block * prev;
+    struct deque_block * next;
+    unsigned int data[DEQUE_BLOCK_CAPACITY];
+};
+
+// Double-ended queue of unsigned ints.
+//
+// The entries, front to back, are head->data[head_index ..] through
+// tail->data[.. tail_index), across however many blocks lie between
+// head and tail. Pushing at either end writes next to the current end
+// and only allocates when that end's block is full, so every
+// operation is O(1) and there is no per-entry malloc().
+//
+// A deque that owns no blocks has head == tail == NULL. The first
+// block is entered in the middle, and a deque that becomes empty
+// recentres in its last block, so a deque used from both ends (as in
+// 0-1 BFS) doesn't keep spilling into new blocks. One drained block is
+// kept as a spare rather than freed.
+//
+struct deque {
+    size_t size;
+    struct deque_block * head;
+    struct deque_block * tail;
+    size_t head_index;
+    size_t tail_index;
+    struct deque_block * spare;
+};
+
+// Creates a new, empty deque.
+// PRECONDITION: Register malloc() and free() functions via the
+//               deque_register_malloc() and
+//               deque_register_free() functions.
+// Returns a new deque on success, NULL on failure.
+//
+struct deque * deque_create(void);
+
+// Deletes a deque and frees all memory associated with it.
+// \param deque : Pointer to deque to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_delete(struct deque * deque);
+
+// Pushes an unsigned int onto the front of the deque.
+// \param deque : Pointer to deque.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_push_front(struct deque * deque, unsigned int data);
+
+// Pushes an unsigned int onto the back of the deque.
+// \param deque : Pointer to deque.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_push_back(struct deque * deque, unsigned int data);
+
+// Pops an unsigned int from the front of the deque, if one exists.
+// \param deque       : Pointer to deque.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_pop_front(struct deque * deque, unsigned int * popped_data);
+
+// Pops an unsigned int from the back of the deque, if one exists.
+// \param deque       : Pointer to deque.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_pop_back(struct deque * deque, unsigned int * popped_data);
+
+// Returns the front of the deque without removing it.
+// \param deque       : Pointer to deque.
+// \param peeked_data : Pointer to peeked data (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_peek_front(struct deque * deque, unsigned int * peeked_data);
+
+// Returns the back of the deque without removing it.
+// \param deque       : Pointer to deque.
+// \param peeked_data : Pointer to peeked data (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_peek_back(struct deque * deque, unsigned int * peeked_data);
+
+// Empties the deque, keeping one block for reuse.
+// \param deque : Pointer to deque.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_clear(struct deque * deque);
+
+// Returns the number of entries in the deque.
+// \param deque : Pointer to deque.
+// Returns size on success, SIZE_MAX on failure.
+//
+size_t deque_size(struct deque * deque);
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_register_malloc(void * (*malloc)(size_t));
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool deque_register_free(void (*free)(void*));
+
+#endif
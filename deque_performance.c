@@ -0,0 +1,234 @@
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "deque.h"
+#include "graph.h"
+
+// Shortest paths over the Wikipedia graph with 0/1 edge weights, solved
+// twice per source: once with 0-1 BFS on a deque (weight 0 edges go to
+// the front, weight 1 edges to the back) and once with Dijkstra's
+// algorithm on a binary heap. The two distance arrays must match.
+// Usage:
+//
+//     ./deque_performance [sources]
+//
+// Sources are read from the "nodes" file, like queue_performance.
+//
+#define GRAB_CLOCK(x) clock_gettime(CLOCK_MONOTONIC, &x);
+#define DEFAULT_SOURCES 10
+#define UNREACHED UINT_MAX
+
+// The Wikipedia graph in CSR form, same as in queue_performance.c.
+//
+struct graph * graph = NULL;
+
+// Entry of the Dijkstra priority queue, ordered by distance.
+//
+struct heap_entry {
+    unsigned int distance;
+    unsigned int vertex;
+};
+
+struct heap_entry * heap = NULL;
+size_t heap_size         = 0;
+
+long compute_timespec_diff(struct timespec start,
+                           struct timespec stop) {
+    return (stop.tv_sec - start.tv_sec) * 1000000000L +
+           (stop.tv_nsec - start.tv_nsec);
+}
+
+// Weight of the edge i -> j. Deterministic, and roughly half of all
+// edges get each weight.
+//
+static inline unsigned int edge_weight(unsigned int i, unsigned int j) {
+    return (i ^ j) & 1;
+}
+
+// Single source shortest paths by 0-1 BFS. A vertex may be pushed more
+// than once; stale copies fail every relaxation and are harmless.
+//
+void zero_one_bfs(struct deque * deque, unsigned int source,
+                  unsigned int * distance, size_t vertices) {
+    for (size_t v = 0; v < vertices; v++) {
+        distance[v] = UNREACHED;
+    }
+    distance[source] = 0;
+    deque_push_back(deque, source);
+
+    unsigned int u;
+    while (deque_pop_front(deque, &u)) {
+        const uint32_t * neighbors = graph_neighbors(graph, u);
+        uint32_t degree = graph_degree(graph, u);
+        for (uint32_t e = 0; e < degree; e++) {
+            unsigned int v = neighbors[e];
+            unsigned int w = edge_weight(u, v);
+            if (distance[u] + w < distance[v]) {
+                distance[v] = distance[u] + w;
+                if (w == 0) {
+                    deque_push_front(deque, v);
+                } else {
+                    deque_push_back(deque, v);
+                }
+            }
+        }
+    }
+}
+
+static void heap_push(unsigned int distance, unsigned int vertex) {
+    size_t i = heap_size++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (heap[parent].distance <= distance) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i].distance = distance;
+    heap[i].vertex   = vertex;
+}
+
+static struct heap_entry heap_pop(void) {
+    struct heap_entry top  = heap[0];
+    struct heap_entry last = heap[--heap_size];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= heap_size) break;
+        if (child + 1 < heap_size && heap[child + 1].distance < heap[child].distance) {
+            ++child;
+        }
+        if (last.distance <= heap[child].distance) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+// Single source shortest paths by Dijkstra's algorithm with lazy
+// deletion. Each vertex is settled once, so each edge is pushed at
+// most once and the heap never holds more than nz + 1 entries.
+//
+void dijkstra(unsigned int source, unsigned int * distance, size_t vertices) {
+    for (size_t v = 0; v < vertices; v++) {
+        distance[v] = UNREACHED;
+    }
+    distance[source] = 0;
+    heap_size = 0;
+    heap_push(0, source);
+
+    while (heap_size > 0) {
+        struct heap_entry top = heap_pop();
+        unsigned int u = top.vertex;
+        if (top.distance != distance[u]) continue;
+        const uint32_t * neighbors = graph_neighbors(graph, u);
+        uint32_t degree = graph_degree(graph, u);
+        for (uint32_t e = 0; e < degree; e++) {
+            unsigned int v = neighbors[e];
+            unsigned int d = distance[u] + edge_weight(u, v);
+            if (d < distance[v]) {
+                distance[v] = d;
+                heap_push(d, v);
+            }
+        }
+    }
+}
+
+int main(int argc, char ** argv) {
+    size_t sources = DEFAULT_SOURCES;
+    if (argc > 1) {
+        sources = strtoul(argv[1], NULL, 10);
+    }
+
+    deque_register_malloc(malloc);
+    deque_register_free(free);
+
+    graph           = graph_load("wikipedia-20070206/wikipedia-20070206.mtx",
+                                 "wikipedia-20070206/wikipedia-20070206.csr");
+    FILE* node_fptr = fopen("nodes", "r");
+    if (graph == NULL) {
+        printf("Error loading matrix.\n");
+        printf("Did you run 'make download_and_decompress_test_data'?\n");
+        return 1;
+    }
+    if (node_fptr == NULL) {
+        printf("Error opening node list.\n");
+        return 1;
+    }
+    printf("Wikipedia matrix size m: %u n: %u nz: %u\n",
+           graph->vertex_count - 1, graph->vertex_count - 1, graph->edge_count);
+
+    size_t vertices = graph->vertex_count;
+    unsigned int * bfs_distance      = malloc(vertices * sizeof(unsigned int));
+    unsigned int * dijkstra_distance = malloc(vertices * sizeof(unsigned int));
+    heap = malloc(((size_t)graph->edge_count + 1) * sizeof(struct heap_entry));
+    struct deque * deque = deque_create();
+    if (bfs_distance == NULL || dijkstra_distance == NULL ||
+        heap == NULL || deque == NULL) {
+        printf("Failed to allocate search state.\n");
+        return 1;
+    }
+
+    long bfs_total      = 0;
+    long dijkstra_total = 0;
+    for (size_t s = 0; s < sources; s++) {
+        unsigned int source, target;
+        if (fscanf(node_fptr, "%u %u", &source, &target) != 2) {
+            break;
+        }
+        if (source >= vertices || target >= vertices) {
+            printf("Source %u or target %u out of range.\n", source, target);
+            return 1;
+        }
+
+        struct timespec start, stop;
+        GRAB_CLOCK(start)
+        zero_one_bfs(deque, source, bfs_distance, vertices);
+        GRAB_CLOCK(stop)
+        long bfs_time = compute_timespec_diff(start, stop);
+
+        GRAB_CLOCK(start)
+        dijkstra(source, dijkstra_distance, vertices);
+        GRAB_CLOCK(stop)
+        long dijkstra_time = compute_timespec_diff(start, stop);
+
+        size_t reached      = 0;
+        unsigned int radius = 0;
+        for (size_t v = 0; v < vertices; v++) {
+            if (bfs_distance[v] != dijkstra_distance[v]) {
+                printf("Mismatch from source %u at vertex %zu: 0-1 BFS %u, Dijkstra %u\n",
+                       source, v, bfs_distance[v], dijkstra_distance[v]);
+                return 1;
+            }
+            if (bfs_distance[v] != UNREACHED) {
+                ++reached;
+                if (bfs_distance[v] > radius) radius = bfs_distance[v];
+            }
+        }
+
+        printf("Source %u: reached %zu vertices, eccentricity %u, distance to %u: %d\n",
+               source, reached, radius, target,
+               bfs_distance[target] == UNREACHED ? -1 : (int)bfs_distance[target]);
+        printf("    0-1 BFS [s]: %0.3f Dijkstra [s]: %0.3f\n",
+               (double)bfs_time / 1e9, (double)dijkstra_time / 1e9);
+        bfs_total      += bfs_time;
+        dijkstra_total += dijkstra_time;
+    }
+
+    printf("Total 0-1 BFS [s]: %0.3f Dijkstra [s]: %0.3f speedup: %0.2fx\n",
+           (double)bfs_total / 1e9, (double)dijkstra_total / 1e9,
+           bfs_total > 0 ? (double)dijkstra_total / (double)bfs_total : 0.0);
+
+    graph_delete(graph);
+    free(bfs_distance);
+    free(dijkstra_distance);
+    free(heap);
+    deque_delete(deque);
+    fclose(node_fptr);
+
+    return 0;
+}
@@ -0,0 +1,926 @@
+/*
+*MIT License
+*
+*Copyright (c) 2025 Siddhant Nadkarni
+*
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*/
+
+
+
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "graph.h"
+#include "mmio.h"
+
+// Smallest share of a Matrix Market file worth a parser thread of its
+// own, and the most parser threads graph_load_mtx() starts.
+//
+#define GRAPH_PARSE_MIN_BYTES   (1 << 20)
+#define GRAPH_PARSE_MAX_THREADS 64
+
+// Number of vertex ranges the edges are bucketed into when a graph is
+// built on several threads. Enough that the buckets spread evenly over
+// the threads, few enough that the per-thread counts stay small.
+//
+#define GRAPH_BUILD_BUCKETS 4096
+
+// Allocates a graph with room for vertex_count vertices and edge_count
+// edges.
+// Returns a new graph on success, NULL on failure.
+//
+static struct graph * graph_alloc(uint32_t vertex_count, uint32_t edge_count){
+    struct graph * graph = malloc(sizeof(struct graph));
+    if(graph == NULL){
+        return NULL;
+    }
+    graph->vertex_count   = vertex_count;
+    graph->edge_count     = edge_count;
+    graph->mapping        = NULL;
+    graph->mapping_length = 0;
+    graph->offsets        = malloc(((size_t)vertex_count + 1) * sizeof(uint32_t));
+    //malloc(0) may return NULL, so always ask for at least one target
+    graph->targets        = malloc(((size_t)edge_count + 1) * sizeof(uint32_t));
+    if(graph->offsets == NULL || graph->targets == NULL){
+        graph_delete(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+// A run of edges, edge e going from sources[e] to targets[e].
+//
+struct graph_edges {
+    const uint32_t * sources;
+    const uint32_t * targets;
+    size_t count;
+};
+
+// Builds a graph from runs of edges taken one after the other, with a
+// counting sort on the source vertex so that edges with the same source
+// keep their order.
+// \param vertex_count : Number of vertices.
+// \param edge_count   : Total number of edges in the runs.
+// \param runs         : Runs of edges.
+// \param run_count    : Number of runs.
+// Returns a new graph on success, NULL on failure.
+//
+static struct graph * graph_build(uint32_t vertex_count, uint32_t edge_count,
+                                  const struct graph_edges * runs, size_t run_count){
+    //check if an endpoint is out of range
+    for(size_t r = 0; r < run_count; r++){
+        for(size_t e = 0; e < runs[r].count; e++){
+            if(runs[r].sources[e] >= vertex_count || runs[r].targets[e] >= vertex_count){
+                return NULL;
+            }
+        }
+    }
+
+    struct graph * graph = graph_alloc(vertex_count, edge_count);
+    if(graph == NULL){
+        return NULL;
+    }
+
+    //count the out-degrees, then turn them into start offsets
+    uint32_t * offsets = graph->offsets;
+    for(uint32_t v = 0; v <= vertex_count; v++){
+        offsets[v] = 0;
+    }
+    for(size_t r = 0; r < run_count; r++){
+        for(size_t e = 0; e < runs[r].count; e++){
+            offsets[runs[r].sources[e]]++;
+        }
+    }
+    uint32_t start = 0;
+    for(uint32_t v = 0; v < vertex_count; v++){
+        uint32_t degree = offsets[v];
+        offsets[v] = start;
+        start += degree;
+    }
+
+    //place every edge in input order, which moves each offset on to the
+    //start of the next vertex, then shift the offsets back into place
+    for(size_t r = 0; r < run_count; r++){
+        for(size_t e = 0; e < runs[r].count; e++){
+            graph->targets[offsets[runs[r].sources[e]]++] = runs[r].targets[e];
+        }
+    }
+    for(uint32_t v = vertex_count; v > 0; v--){
+        offsets[v] = offsets[v - 1];
+    }
+    offsets[0] = 0;
+
+    return graph;
+}
+
+// Builds a graph from an edge list.
+// \param vertex_count : Number of vertices.
+// \param edge_count   : Number of edges.
+// \param sources      : Source vertex of each edge.
+// \param targets      : Target vertex of each edge.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_create(uint32_t vertex_count, uint32_t edge_count,
+                            const uint32_t * sources, const uint32_t * targets){
+    //check if input is NULL
+    if(vertex_count == 0 || (edge_count > 0 && (sources == NULL || targets == NULL))){
+        return NULL;
+    }
+    struct graph_edges run = { sources, targets, edge_count };
+    return graph_build(vertex_count, edge_count, &run, 1);
+}
+
+// Runs work() on every task of an array, the first on the calling
+// thread and the others on threads of their own, and returns once all
+// of them are done. A task that no thread could be started for is run
+// on the calling thread as well.
+// \param work      : Function to run.
+// \param tasks     : Array of task_count tasks, passed to work() one each.
+// \param task_size : Size of one task in bytes.
+// \param task_count: Number of tasks, at most GRAPH_PARSE_MAX_THREADS.
+//
+static void graph_run_tasks(void * (*work)(void *), void * tasks,
+                            size_t task_size, size_t task_count){
+    pthread_t threads[GRAPH_PARSE_MAX_THREADS];
+    unsigned char * task = tasks;
+    size_t started       = 1;
+    for(; started < task_count; started++){
+        if(pthread_create(&threads[started], NULL, work, task + started * task_size) != 0){
+            break;
+        }
+    }
+    work(task);
+    for(size_t t = 1; t < started; t++){
+        pthread_join(threads[t], NULL);
+    }
+    for(size_t t = started; t < task_count; t++){
+        work(task + t * task_size);
+    }
+}
+
+// State shared by the threads of graph_build_parallel(). Run t belongs
+// to thread t. Vertices are grouped into bucket_count buckets of
+// 1 << bucket_shift consecutive ids, and the edges are first gathered
+// into pair_sources and pair_targets ordered by bucket, with run t's
+// edges of bucket b starting at positions[t * bucket_count + b].
+// bucket_starts[b] is where bucket b begins, in the pairs and in the
+// final targets alike.
+//
+struct graph_build_shared {
+    const struct graph_edges * runs;
+    size_t run_count;
+    uint32_t vertex_count;
+    uint32_t edge_count;
+    unsigned int bucket_shift;
+    size_t bucket_count;
+    size_t * positions;
+    size_t * bucket_starts;
+    uint32_t * pair_sources;
+    uint32_t * pair_targets;
+    struct graph * graph;
+};
+
+struct graph_build_task {
+    struct graph_build_shared * shared;
+    size_t index;
+    bool ok;
+};
+
+// Pass 1: counts run t's edges per bucket, checking every endpoint.
+//
+static void * graph_build_count(void * argument){
+    struct graph_build_task * task    = argument;
+    struct graph_build_shared * build = task->shared;
+    const struct graph_edges * run    = &build->runs[task->index];
+    size_t * counts = build->positions + task->index * build->bucket_count;
+    task->ok        = false;
+    for(size_t b = 0; b < build->bucket_count; b++){
+        counts[b] = 0;
+    }
+    for(size_t e = 0; e < run->count; e++){
+        if(run->sources[e] >= build->vertex_count || run->targets[e] >= build->vertex_count){
+            return NULL;
+        }
+        counts[run->sources[e] >> build->bucket_shift]++;
+    }
+    task->ok = true;
+    return NULL;
+}
+
+// Pass 2: copies run t's edges to its slots of their buckets.
+//
+static void * graph_build_scatter(void * argument){
+    struct graph_build_task * task    = argument;
+    struct graph_build_shared * build = task->shared;
+    const struct graph_edges * run    = &build->runs[task->index];
+    size_t * positions = build->positions + task->index * build->bucket_count;
+    for(size_t e = 0; e < run->count; e++){
+        size_t position = positions[run->sources[e] >> build->bucket_shift]++;
+        build->pair_sources[position] = run->sources[e];
+        build->pair_targets[position] = run->targets[e];
+    }
+    return NULL;
+}
+
+// Pass 3: counting sorts the buckets that start in thread t's share of
+// the edges into the graph. Every bucket owns its own slice of offsets
+// and targets, so no two threads write the same memory.
+//
+static void * graph_build_place(void * argument){
+    struct graph_build_task * task    = argument;
+    struct graph_build_shared * build = task->shared;
+    uint32_t * offsets = build->graph->offsets;
+    uint32_t * targets = build->graph->targets;
+    for(size_t b = 0; b < build->bucket_count; b++){
+        size_t start = build->bucket_starts[b];
+        size_t end   = build->bucket_starts[b + 1];
+        size_t owner = build->edge_count == 0 ? 0 : start * build->run_count / build->edge_count;
+        if((owner < build->run_count ? owner : build->run_count - 1) != task->index){
+            continue;
+        }
+        uint32_t low  = (uint32_t)(b << build->bucket_shift);
+        uint32_t high = (size_t)(b + 1) << build->bucket_shift < build->vertex_count ?
+                        (uint32_t)((b + 1) << build->bucket_shift) : build->vertex_count;
+
+        //same steps as graph_build(), on this bucket's vertices only
+        for(uint32_t v = low; v < high; v++){
+            offsets[v] = 0;
+        }
+        for(size_t e = start; e < end; e++){
+            offsets[build->pair_sources[e]]++;
+        }
+        uint32_t next = (uint32_t)start;
+        for(uint32_t v = low; v < high; v++){
+            uint32_t degree = offsets[v];
+            offsets[v] = next;
+            next += degree;
+        }
+        for(size_t e = start; e < end; e++){
+            targets[offsets[build->pair_sources[e]]++] = build->pair_targets[e];
+        }
+        for(uint32_t v = high - 1; v > low; v--){
+            offsets[v] = offsets[v - 1];
+        }
+        offsets[low] = (uint32_t)start;
+    }
+    return NULL;
+}
+
+// graph_build() spread over one thread per run. The edges are first
+// bucketed by source vertex range, which keeps them in input order
+// within each bucket, and the buckets are then counting sorted
+// independently.
+// \param vertex_count : Number of vertices.
+// \param edge_count   : Total number of edges in the runs.
+// \param runs         : Runs of edges.
+// \param run_count    : Number of runs, at most GRAPH_PARSE_MAX_THREADS.
+// Returns a new graph on success, NULL on failure.
+//
+static struct graph * graph_build_parallel(uint32_t vertex_count, uint32_t edge_count,
+                                           const struct graph_edges * runs, size_t run_count){
+    if(run_count <= 1){
+        return graph_build(vertex_count, edge_count, runs, run_count);
+    }
+
+    struct graph_build_shared build;
+    struct graph_build_task tasks[GRAPH_PARSE_MAX_THREADS];
+    build.runs         = runs;
+    build.run_count    = run_count;
+    build.vertex_count = vertex_count;
+    build.edge_count   = edge_count;
+    build.bucket_shift = 0;
+    while(((size_t)vertex_count >> build.bucket_shift) >= GRAPH_BUILD_BUCKETS){
+        build.bucket_shift++;
+    }
+    build.bucket_count  = (((size_t)vertex_count - 1) >> build.bucket_shift) + 1;
+    build.positions     = malloc(run_count * build.bucket_count * sizeof(size_t));
+    build.bucket_starts = malloc((build.bucket_count + 1) * sizeof(size_t));
+    build.pair_sources  = malloc(((size_t)edge_count + 1) * sizeof(uint32_t));
+    build.pair_targets  = malloc(((size_t)edge_count + 1) * sizeof(uint32_t));
+    build.graph         = NULL;
+    for(size_t t = 0; t < run_count; t++){
+        tasks[t].shared = &build;
+        tasks[t].index  = t;
+        tasks[t].ok     = true;
+    }
+
+    bool ok = build.positions != NULL && build.bucket_starts != NULL &&
+              build.pair_sources != NULL && build.pair_targets != NULL;
+    if(ok){
+        graph_run_tasks(graph_build_count, tasks, sizeof(tasks[0]), run_count);
+        for(size_t t = 0; t < run_count; t++){
+            ok = ok && tasks[t].ok;
+        }
+    }
+    if(ok){
+        //turn the counts into positions, bucket by bucket and run by run
+        //within a bucket, so each bucket keeps the input order
+        size_t position = 0;
+        for(size_t b = 0; b < build.bucket_count; b++){
+            build.bucket_starts[b] = position;
+            for(size_t t = 0; t < run_count; t++){
+                size_t count = build.positions[t * build.bucket_count + b];
+                build.positions[t * build.bucket_count + b] = position;
+                position += count;
+            }
+        }
+        build.bucket_starts[build.bucket_count] = position;
+        graph_run_tasks(graph_build_scatter, tasks, sizeof(tasks[0]), run_count);
+
+        build.graph = graph_alloc(vertex_count, edge_count);
+        if(build.graph != NULL){
+            graph_run_tasks(graph_build_place, tasks, sizeof(tasks[0]), run_count);
+            build.graph->offsets[vertex_count] = edge_count;
+        }
+    }
+
+    free(build.positions);
+    free(build.bucket_starts);
+    free(build.pair_sources);
+    free(build.pair_targets);
+    return build.graph;
+}
+
+// One thread's share of a Matrix Market file: the entry lines in
+// [begin, end), decoded into sources and targets.
+//
+struct graph_parse_task {
+    const char * begin;
+    const char * end;
+    unsigned int values;
+    uint32_t * sources;
+    uint32_t * targets;
+    size_t count;
+    bool ok;
+};
+
+// Decodes the unsigned decimal at p, after any blanks, into *value.
+// Returns a pointer just past the digits, NULL if there are none or the
+// number doesn't fit in 32 bits.
+//
+static inline const char * graph_parse_index(const char * p, const char * end,
+                                             uint32_t * value){
+    while(p < end && (*p == ' ' || *p == '\t')){
+        p++;
+    }
+    const char * digits = p;
+    uint64_t decoded    = 0;
+    while(p < end && (unsigned char)(*p - '0') < 10 && p - digits < 11){
+        decoded = decoded * 10 + (unsigned char)(*p - '0');
+        p++;
+    }
+    if(p == digits || decoded > UINT32_MAX){
+        return NULL;
+    }
+    *value = (uint32_t)decoded;
+    return p;
+}
+
+// Decodes the entry lines of one task. Only the two coordinates of a
+// line are decoded. They must be followed by as many values as the
+// matrix type has, none for pattern, one for integer or real and two
+// for complex, which are skipped as runs of non-blank characters, and
+// then by the end of the line.
+//
+static void * graph_parse_range(void * argument){
+    struct graph_parse_task * task = argument;
+    const char * p   = task->begin;
+    const char * end = task->end;
+    size_t count     = 0;
+    task->ok         = false;
+    while(p < end){
+        //blank lines carry no entry
+        while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')){
+            p++;
+        }
+        if(p == end){
+            break;
+        }
+        if(*p == '\n'){
+            p++;
+            continue;
+        }
+
+        uint32_t i, j;
+        p = graph_parse_index(p, end, &i);
+        p = p == NULL ? NULL : graph_parse_index(p, end, &j);
+        if(p == NULL){
+            return NULL;
+        }
+        for(unsigned int v = 0; v < task->values; v++){
+            const char * separator = p;
+            while(p < end && (*p == ' ' || *p == '\t')){
+                p++;
+            }
+            const char * value = p;
+            while(p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n'){
+                p++;
+            }
+            if(separator == value || value == p){
+                return NULL;
+            }
+        }
+        while(p < end && (*p == ' ' || *p == '\t' || *p == '\r')){
+            p++;
+        }
+        if(p < end && *p != '\n'){
+            return NULL;
+        }
+        task->sources[count] = i;
+        task->targets[count] = j;
+        count++;
+        p = p < end ? p + 1 : end;
+    }
+    task->count = count;
+    task->ok    = true;
+    return NULL;
+}
+
+// Reads the banner and size line of a Matrix Market file, leaving
+// fptr at the first entry. Ids are 1-based, so vertex 0 stays unused.
+// Returns TRUE if the file is a coordinate matrix that fits a graph.
+//
+static bool graph_read_mtx_header(FILE * fptr, MM_typecode * matrix_code,
+                                  uint32_t * vertex_count, uint32_t * edge_count){
+    int m, n, nz;
+    if(mm_read_banner(fptr, matrix_code) != 0 || !mm_is_coordinate(*matrix_code) ||
+       mm_read_mtx_crd_size(fptr, &m, &n, &nz) != 0 || m < 0 || n < 0 || nz < 0 ||
+       m >= INT32_MAX || n >= INT32_MAX){
+        return false;
+    }
+    *vertex_count = (uint32_t)(m > n ? m : n) + 1;
+    *edge_count   = (uint32_t)nz;
+    return true;
+}
+
+// Callback results of graph_read_mtx() that stop the stream, next to
+// the mmio error codes, which are all positive.
+//
+#define GRAPH_STREAM_DONE      (-1)
+#define GRAPH_STREAM_BAD_ENTRY (-2)
+
+// Progress of one pass of graph_read_mtx() over the entries.
+//
+struct graph_stream {
+    struct graph * graph;
+    uint32_t remaining;
+    bool placing;
+};
+
+// Takes a batch of entries: the first pass counts out-degrees into
+// offsets, the second places targets, both stopping after edge_count
+// entries.
+//
+static int graph_stream_entries(void * ctx, int count, const int I[],
+                                const int J[], const double val[]){
+    struct graph_stream * stream = ctx;
+    struct graph * graph         = stream->graph;
+    (void)val;
+    for(int k = 0; k < count; k++){
+        if(stream->remaining == 0){
+            return GRAPH_STREAM_DONE;
+        }
+        if(I[k] < 0 || J[k] < 0 || (uint32_t)I[k] >= graph->vertex_count ||
+           (uint32_t)J[k] >= graph->vertex_count){
+            return GRAPH_STREAM_BAD_ENTRY;
+        }
+        if(stream->placing){
+            //only a file changed between the passes gets here
+            if(graph->offsets[I[k]] >= graph->edge_count){
+                return GRAPH_STREAM_BAD_ENTRY;
+            }
+            graph->targets[graph->offsets[I[k]]++] = (uint32_t)J[k];
+        }
+        else{
+            graph->offsets[I[k]]++;
+        }
+        stream->remaining--;
+    }
+    return 0;
+}
+
+// Reads a graph from a Matrix Market stream.
+// \param fptr : Seekable stream positioned at the start of the file.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_read_mtx(FILE * fptr){
+    //check if input is NULL
+    if(fptr == NULL){
+        return NULL;
+    }
+    MM_typecode matrix_code;
+    uint32_t vertex_count, edge_count;
+    if(!graph_read_mtx_header(fptr, &matrix_code, &vertex_count, &edge_count)){
+        return NULL;
+    }
+    long entries = ftell(fptr);
+    if(entries < 0){
+        return NULL;
+    }
+    struct graph * graph = graph_alloc(vertex_count, edge_count);
+    if(graph == NULL){
+        return NULL;
+    }
+
+    //count the out-degrees, then turn them into start offsets
+    struct graph_stream stream = { graph, edge_count, false };
+    uint32_t * offsets = graph->offsets;
+    for(uint32_t v = 0; v <= vertex_count; v++){
+        offsets[v] = 0;
+    }
+    int status = mm_read_mtx_crd_stream(fptr, matrix_code, graph_stream_entries, &stream, 0);
+    bool ok    = (status == 0 || status == GRAPH_STREAM_DONE) && stream.remaining == 0;
+    uint32_t start = 0;
+    for(uint32_t v = 0; ok && v < vertex_count; v++){
+        uint32_t degree = offsets[v];
+        offsets[v] = start;
+        start += degree;
+    }
+
+    //go over the same entries again to place them, then shift the
+    //offsets back into place as in graph_build()
+    if(ok && fseek(fptr, entries, SEEK_SET) == 0){
+        stream.remaining = edge_count;
+        stream.placing   = true;
+        status = mm_read_mtx_crd_stream(fptr, matrix_code, graph_stream_entries, &stream, 0);
+        ok     = (status == 0 || status == GRAPH_STREAM_DONE) && stream.remaining == 0;
+    }
+    else{
+        ok = false;
+    }
+    if(!ok){
+        graph_delete(graph);
+        return NULL;
+    }
+    for(uint32_t v = vertex_count; v > 0; v--){
+        offsets[v] = offsets[v - 1];
+    }
+    offsets[0] = 0;
+    return graph;
+}
+
+// Reads a graph from a Matrix Market coordinate file using
+// thread_count threads.
+// \param path         : Path to the .mtx file.
+// \param thread_count : Number of threads, 0 for one per online CPU
+//                       and MiB of entries.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_load_mtx_threads(const char * path, unsigned int thread_count){
+    //check if input is NULL
+    if(path == NULL){
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if(fd < 0){
+        return NULL;
+    }
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0){
+        close(fd);
+        return NULL;
+    }
+    size_t length = (size_t)file_stat.st_size;
+    char * data   = file_stat.st_size > 0 ?
+                    mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+
+    //what can't be mapped is read as a stream instead
+    if(data == MAP_FAILED){
+        FILE * fptr = fopen(path, "r");
+        if(fptr == NULL){
+            return NULL;
+        }
+        struct graph * graph = graph_read_mtx(fptr);
+        fclose(fptr);
+        return graph;
+    }
+    madvise(data, length, MADV_SEQUENTIAL);
+
+    //let mmio read the banner and size line, which also tells us where
+    //the entries start
+    MM_typecode matrix_code;
+    uint32_t vertex_count, edge_count;
+    long header_length = -1;
+    FILE * header = fmemopen(data, length, "r");
+    if(header != NULL){
+        if(graph_read_mtx_header(header, &matrix_code, &vertex_count, &edge_count)){
+            header_length = ftell(header);
+        }
+        fclose(header);
+    }
+    if(header_length < 0){
+        munmap(data, length);
+        return NULL;
+    }
+
+    //by default one thread per online CPU, but no more than one per
+    //GRAPH_PARSE_MIN_BYTES of entries
+    const char * entries = data + header_length;
+    size_t entry_bytes   = length - (size_t)header_length;
+    size_t task_count    = thread_count;
+    if(thread_count == 0){
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        task_count  = entry_bytes / GRAPH_PARSE_MIN_BYTES + 1;
+        if(online > 0 && task_count > (size_t)online){
+            task_count = (size_t)online;
+        }
+        else if(online <= 0){
+            task_count = 1;
+        }
+    }
+    if(task_count > GRAPH_PARSE_MAX_THREADS){
+        task_count = GRAPH_PARSE_MAX_THREADS;
+    }
+
+    //split at line boundaries; an entry line is at least "1 1\n", so a
+    //range of b bytes holds at most b / 4 + 1 entries
+    struct graph_parse_task tasks[GRAPH_PARSE_MAX_THREADS];
+    struct graph_edges runs[GRAPH_PARSE_MAX_THREADS];
+    const char * range_begin = entries;
+    bool ok = true;
+    for(size_t t = 0; t < task_count; t++){
+        const char * range_end = entries + entry_bytes * (t + 1) / task_count;
+        if(t + 1 < task_count && range_end > range_begin){
+            const char * newline = memchr(range_end - 1, '\n',
+                                          (size_t)(entries + entry_bytes - (range_end - 1)));
+            range_end = newline == NULL ? entries + entry_bytes : newline + 1;
+        }
+        if(range_end < range_begin){
+            range_end = range_begin;
+        }
+        size_t capacity       = (size_t)(range_end - range_begin) / 4 + 1;
+        tasks[t].begin        = range_begin;
+        tasks[t].end          = range_end;
+        tasks[t].values       = mm_is_complex(matrix_code) ? 2 : mm_is_pattern(matrix_code) ? 0 : 1;
+        tasks[t].count        = 0;
+        tasks[t].ok           = false;
+        tasks[t].sources      = malloc(capacity * sizeof(uint32_t));
+        tasks[t].targets      = malloc(capacity * sizeof(uint32_t));
+        ok = ok && tasks[t].sources != NULL && tasks[t].targets != NULL;
+        range_begin = range_end;
+    }
+
+    if(ok){
+        graph_run_tasks(graph_parse_range, tasks, sizeof(tasks[0]), task_count);
+    }
+
+    //keep the first nz entries, in file order
+    struct graph * graph = NULL;
+    size_t remaining     = edge_count;
+    for(size_t t = 0; ok && t < task_count; t++){
+        ok = tasks[t].ok;
+        runs[t].sources = tasks[t].sources;
+        runs[t].targets = tasks[t].targets;
+        runs[t].count   = tasks[t].count < remaining ? tasks[t].count : remaining;
+        remaining      -= runs[t].count;
+    }
+    if(ok && remaining == 0){
+        graph = graph_build_parallel(vertex_count, edge_count, runs, task_count);
+    }
+
+    for(size_t t = 0; t < task_count; t++){
+        free(tasks[t].sources);
+        free(tasks[t].targets);
+    }
+    munmap(data, length);
+    return graph;
+}
+
+// Reads a graph from a Matrix Market coordinate file.
+// \param path : Path to the .mtx file.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_load_mtx(const char * path){
+    return graph_load_mtx_threads(path, 0);
+}
+
+// Fletcher-style checksum of a run of words, continuing from *sum1
+// and *sum2. Two running sums, so swapped or shifted words change it
+// as well as flipped bits, and cheap enough to run at memory speed.
+//
+static void graph_checksum_update(const uint32_t * words, size_t count,
+                                  uint64_t * sum1, uint64_t * sum2){
+    uint64_t a = *sum1;
+    uint64_t b = *sum2;
+    for(size_t i = 0; i < count; i++){
+        a += words[i];
+        b += a;
+    }
+    *sum1 = a;
+    *sum2 = b;
+}
+
+static uint64_t graph_checksum(const uint32_t * offsets, size_t offset_count,
+                               const uint32_t * targets, size_t target_count){
+    uint64_t sum1 = 0;
+    uint64_t sum2 = 0;
+    graph_checksum_update(offsets, offset_count, &sum1, &sum2);
+    graph_checksum_update(targets, target_count, &sum1, &sum2);
+    return sum2 ^ (sum1 << 32) ^ (sum1 >> 32);
+}
+
+// Writes a graph to a cache file that graph_map() can read back.
+// \param graph : Pointer to graph to write.
+// \param path  : Path of the cache file.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_save(const struct graph * graph, const char * path){
+    //check if input is NULL
+    if(graph == NULL || path == NULL){
+        return false;
+    }
+
+    size_t offset_count = (size_t)graph->vertex_count + 1;
+    size_t target_count = graph->edge_count;
+    struct graph_cache_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_CACHE_MAGIC, sizeof(header.magic));
+    header.version      = GRAPH_CACHE_VERSION;
+    header.byte_order   = GRAPH_CACHE_BYTE_ORDER;
+    header.vertex_count = graph->vertex_count;
+    header.edge_count   = graph->edge_count;
+    header.checksum     = graph_checksum(graph->offsets, offset_count,
+                                         graph->targets, target_count);
+
+    //write next to the destination so the rename stays on one file system
+    size_t temp_length = strlen(path) + 32;
+    char * temp_path   = malloc(temp_length);
+    if(temp_path == NULL){
+        return false;
+    }
+    snprintf(temp_path, temp_length, "%s.tmp.%ld", path, (long)getpid());
+    FILE * fptr = fopen(temp_path, "wb");
+    if(fptr == NULL){
+        free(temp_path);
+        return false;
+    }
+    bool status = fwrite(&header, sizeof(header), 1, fptr) == 1 &&
+                  fwrite(graph->offsets, sizeof(uint32_t), offset_count, fptr) == offset_count &&
+                  fwrite(graph->targets, sizeof(uint32_t), target_count, fptr) == target_count;
+    status = fclose(fptr) == 0 && status;
+    status = status && rename(temp_path, path) == 0;
+    if(!status){
+        remove(temp_path);
+    }
+    free(temp_path);
+    return status;
+}
+
+// Checks that a mapped cache file holds a well formed graph: the header
+// matches this build and the file size, the checksum matches, offsets
+// run from 0 to edge_count without going backwards and every target is
+// a vertex.
+//
+static bool graph_cache_valid(const unsigned char * data, size_t length){
+    if(length < sizeof(struct graph_cache_header)){
+        return false;
+    }
+    struct graph_cache_header header;
+    memcpy(&header, data, sizeof(header));
+    if(memcmp(header.magic, GRAPH_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+       header.version != GRAPH_CACHE_VERSION ||
+       header.byte_order != GRAPH_CACHE_BYTE_ORDER ||
+       header.vertex_count == 0 ||
+       length != sizeof(header) + ((size_t)header.vertex_count + 1 +
+                                   header.edge_count) * sizeof(uint32_t)){
+        return false;
+    }
+
+    const uint32_t * offsets = (const uint32_t *)(data + sizeof(header));
+    const uint32_t * targets = offsets + header.vertex_count + 1;
+    if(graph_checksum(offsets, (size_t)header.vertex_count + 1,
+                      targets, header.edge_count) != header.checksum){
+        return false;
+    }
+    if(offsets[0] != 0 || offsets[header.vertex_count] != header.edge_count){
+        return false;
+    }
+    for(uint32_t v = 0; v < header.vertex_count; v++){
+        if(offsets[v] > offsets[v + 1]){
+            return false;
+        }
+    }
+    for(uint32_t e = 0; e < header.edge_count; e++){
+        if(targets[e] >= header.vertex_count){
+            return false;
+        }
+    }
+    return true;
+}
+
+// Maps a cache file written by graph_save() read-only.
+// \param path : Path of the cache file.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_map(const char * path){
+    //check if input is NULL
+    if(path == NULL){
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if(fd < 0){
+        return NULL;
+    }
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0){
+        close(fd);
+        return NULL;
+    }
+
+    //validation reads every page anyway, so fault them all in up front
+    size_t length = (size_t)file_stat.st_size;
+    void * data   = mmap(NULL, length, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED){
+        return NULL;
+    }
+    struct graph * graph = malloc(sizeof(struct graph));
+    if(graph == NULL || !graph_cache_valid(data, length)){
+        free(graph);
+        munmap(data, length);
+        return NULL;
+    }
+
+    const struct graph_cache_header * header = data;
+    graph->vertex_count   = header->vertex_count;
+    graph->edge_count     = header->edge_count;
+    graph->offsets        = (uint32_t *)((unsigned char *)data + sizeof(*header));
+    graph->targets        = graph->offsets + graph->vertex_count + 1;
+    graph->mapping        = data;
+    graph->mapping_length = length;
+    return graph;
+}
+
+// Loads a graph from its cache file if that is current, and from the
+// .mtx file otherwise.
+// \param mtx_path   : Path to the .mtx file.
+// \param cache_path : Path of the cache file, may be NULL.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_load(const char * mtx_path, const char * cache_path){
+    //check if input is NULL
+    if(mtx_path == NULL){
+        return NULL;
+    }
+    struct stat mtx_stat, cache_stat;
+    if(cache_path != NULL && stat(cache_path, &cache_stat) == 0){
+        //a missing .mtx doesn't make the cache stale
+        bool current = stat(mtx_path, &mtx_stat) != 0 ||
+                       cache_stat.st_mtim.tv_sec > mtx_stat.st_mtim.tv_sec ||
+                       (cache_stat.st_mtim.tv_sec == mtx_stat.st_mtim.tv_sec &&
+                        cache_stat.st_mtim.tv_nsec >= mtx_stat.st_mtim.tv_nsec);
+        if(current){
+            struct graph * graph = graph_map(cache_path);
+            if(graph != NULL){
+                return graph;
+            }
+        }
+    }
+    return graph_load_mtx(mtx_path);
+}
+
+// Deletes a graph and frees all memory associated with it, or unmaps
+// its cache file.
+// \param graph : Pointer to graph to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_delete(struct graph * graph){
+    //check if input is NULL
+    if(graph == NULL){
+        return false;
+    }
+    if(graph->mapping != NULL){
+        munmap(graph->mapping, graph->mapping_length);
+    }
+    else{
+        free(graph->offsets);
+        free(graph->targets);
+    }
+    free(graph);
+    return true;
+}
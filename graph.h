@@ -0,0 +1,147 @@
+#ifndef _GRAPH_H
+#define _GRAPH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Directed graph in compressed sparse row (CSR) form.
+//
+// The out-edges of vertex v are targets[offsets[v] .. offsets[v + 1]),
+// in the order they were added, so the whole graph is two flat arrays
+// and visiting a vertex's neighbours is one load of offsets followed by
+// a sequential scan of targets. Vertices are numbered 0 through
+// vertex_count - 1; a graph read from a Matrix Market file keeps the
+// file's 1-based ids, so vertex 0 simply has no edges.
+//
+// A graph returned by graph_map() points offsets and targets straight
+// into a read-only mapping of a cache file (mapping, mapping_length)
+// and must not be written to; for every other graph mapping is NULL.
+//
+struct graph {
+    uint32_t vertex_count;
+    uint32_t edge_count;
+    uint32_t * offsets;
+    uint32_t * targets;
+    void * mapping;
+    size_t mapping_length;
+};
+
+// Graph cache file format, see graph_save().
+//
+#define GRAPH_CACHE_MAGIC      "CSRGRAPH"
+#define GRAPH_CACHE_VERSION    1
+#define GRAPH_CACHE_BYTE_ORDER 0x01020304u
+
+// Header of a graph cache file. It is followed by the vertex_count + 1
+// offsets and then the edge_count targets, all as native uint32_t, so
+// the file is the in-memory CSR arrays verbatim. checksum covers both
+// arrays. byte_order is GRAPH_CACHE_BYTE_ORDER as written by the
+// machine that made the file, which is how a file from a machine of
+// the other endianness is told apart.
+//
+struct graph_cache_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t vertex_count;
+    uint32_t edge_count;
+    uint64_t checksum;
+};
+
+// Builds a graph from an edge list. Edge e goes from sources[e] to
+// targets[e], and edges with the same source keep their relative order.
+// \param vertex_count : Number of vertices, every endpoint must be below it.
+// \param edge_count   : Number of edges.
+// \param sources      : Source vertex of each edge.
+// \param targets      : Target vertex of each edge.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_create(uint32_t vertex_count, uint32_t edge_count,
+                            const uint32_t * sources, const uint32_t * targets);
+
+// Reads a graph from a Matrix Market coordinate file. Entry (i, j) is
+// the edge i -> j; values, if the file has any, are ignored. The file
+// is mapped and split at line boundaries into one range per online
+// CPU, each decoded by its own thread. A file that can't be mapped is
+// read with graph_read_mtx() instead.
+//
+// Every entry line must hold the two indices and exactly as many
+// values as the matrix type has (none for pattern, one for integer and
+// real, two for complex). Values are counted but not decoded, so any
+// token stands in for a number here, while graph_read_mtx(), which
+// goes through mmio, also requires each value to be one and takes
+// entries split across lines.
+// \param path : Path to the .mtx file.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_load_mtx(const char * path);
+
+// Reads a graph from a Matrix Market coordinate stream, such as a file
+// that can't be mapped. Entries are taken from the stream in batches
+// and counted into the CSR arrays on a first pass, then placed on a
+// second, so apart from the graph itself only one batch is held in
+// memory.
+// \param fptr : Seekable stream positioned at the start of the file.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_read_mtx(FILE * fptr);
+
+// graph_load_mtx() with a chosen number of parser threads.
+// \param path         : Path to the .mtx file.
+// \param thread_count : Number of threads, at most 64. 0 picks one per
+//                       online CPU, but no more than one per MiB of
+//                       entries.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_load_mtx_threads(const char * path, unsigned int thread_count);
+
+// Writes a graph to a cache file that graph_map() can read back. The
+// file is written under a temporary name and renamed into place, so a
+// process mapping path concurrently never sees it half written.
+// \param graph : Pointer to graph to write.
+// \param path  : Path of the cache file.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_save(const struct graph * graph, const char * path);
+
+// Maps a cache file written by graph_save() read-only and returns a
+// graph that uses it in place: nothing is copied or parsed, and every
+// process mapping the same file shares one page cache copy of it. The
+// header, checksum and CSR structure are verified first, so a stale,
+// truncated or corrupt file is rejected rather than searched.
+// \param path : Path of the cache file.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_map(const char * path);
+
+// Loads a graph from the cache file if there is one at least as new as
+// the .mtx file and it maps cleanly, and from the .mtx file otherwise.
+// \param mtx_path   : Path to the .mtx file.
+// \param cache_path : Path of the cache file, may be NULL.
+// Returns a new graph on success, NULL on failure.
+//
+struct graph * graph_load(const char * mtx_path, const char * cache_path);
+
+// Deletes a graph and frees all memory associated with it, or unmaps
+// its cache file.
+// \param graph : Pointer to graph to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool graph_delete(struct graph * graph);
+
+// Returns the number of out-edges of vertex v.
+//
+static inline uint32_t graph_degree(const struct graph * graph, uint32_t v){
+    return graph->offsets[v + 1] - graph->offsets[v];
+}
+
+// Returns the targets of the out-edges of vertex v, graph_degree() of
+// them.
+//
+static inline const uint32_t * graph_neighbors(const struct graph * graph, uint32_t v){
+    return graph->targets + graph->offsets[v];
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+*MIT License
+*
+*Copyright (c) 2025 Siddhant Nadkarni
+*
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "graph.h"
+
+// Converts a Matrix Market graph into the binary cache file read by
+// graph_map(), so the performance drivers can skip parsing the text
+// file. Run it once after downloading the test data; the drivers pick
+// the cache up on their own as long as it is newer than the .mtx.
+// threads sets the number of parser threads, one per online CPU by
+// default.
+// Usage:
+//
+//     ./graph_convert [input.mtx [output.csr [threads]]]
+//
+#define GRAB_CLOCK(x) clock_gettime(CLOCK_MONOTONIC, &x);
+#define DEFAULT_MTX_PATH   "wikipedia-20070206/wikipedia-20070206.mtx"
+#define DEFAULT_CACHE_PATH "wikipedia-20070206/wikipedia-20070206.csr"
+
+long compute_timespec_diff(struct timespec start,
+                           struct timespec stop) {
+    return (stop.tv_sec - start.tv_sec) * 1000000000L +
+           (stop.tv_nsec - start.tv_nsec);
+}
+
+int main(int argc, char ** argv) {
+    const char * mtx_path   = argc > 1 ? argv[1] : DEFAULT_MTX_PATH;
+    const char * cache_path = argc > 2 ? argv[2] : DEFAULT_CACHE_PATH;
+    unsigned int threads    = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : 0;
+    struct timespec start, parsed, saved, mapped;
+
+    GRAB_CLOCK(start)
+    struct graph * graph = graph_load_mtx_threads(mtx_path, threads);
+    GRAB_CLOCK(parsed)
+    if (graph == NULL) {
+        printf("Error loading %s.\n", mtx_path);
+        return 1;
+    }
+    if (!graph_save(graph, cache_path)) {
+        printf("Error writing %s.\n", cache_path);
+        graph_delete(graph);
+        return 1;
+    }
+    GRAB_CLOCK(saved)
+
+    // Map the file straight back so a bad write is caught here rather
+    // than silently ignored by the drivers.
+    //
+    struct graph * mapped_graph = graph_map(cache_path);
+    GRAB_CLOCK(mapped)
+    if (mapped_graph == NULL ||
+        mapped_graph->vertex_count != graph->vertex_count ||
+        mapped_graph->edge_count != graph->edge_count) {
+        printf("Error verifying %s.\n", cache_path);
+        graph_delete(mapped_graph);
+        graph_delete(graph);
+        return 1;
+    }
+
+    printf("Vertices: %u edges: %u\n", graph->vertex_count, graph->edge_count);
+    struct stat mtx_stat;
+    double parse_seconds = (double)compute_timespec_diff(start, parsed) / 1e9;
+    stat(mtx_path, &mtx_stat);
+    printf("Parsed %s in [s]: %0.3f (%0.1f MB/s)\n", mtx_path, parse_seconds,
+           (double)mtx_stat.st_size / 1e6 / parse_seconds);
+    printf("Wrote %s (%zu bytes) in [s]: %0.3f\n", cache_path, mapped_graph->mapping_length,
+           (double)compute_timespec_diff(parsed, saved) / 1e9);
+    printf("Mapped and verified it in [s]: %0.3f\n",
+           (double)compute_timespec_diff(saved, mapped) / 1e9);
+
+    graph_delete(mapped_graph);
+    graph_delete(graph);
+    return 0;
+}
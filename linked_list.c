@@ -23,18 +23,1042 @@
 */
 
 
+#include <limits.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 #include "linked_list.h"
 
-// Function pointers to (potentially) custom malloc() and
-// free() functions.
+// Function pointers to (potentially) custom malloc() and
+// free() functions.
+//
+static void * (*malloc_fptr)(size_t size) = NULL;
+static void   (*free_fptr)(void* addr)    = NULL; 
+
+// Number of nodes carved out of a single slab. A slab is a little
+// over 64 KiB on a 64-bit machine.
+//
+#define NODE_POOL_SLAB_NODES 4096
+
+// A slab of nodes allocated with a single malloc_fptr() call.
+//
+struct node_slab {
+    struct node_slab * next;
+    struct node nodes[NODE_POOL_SLAB_NODES];
+};
+
+// Process wide node pool. Nodes released by linked_list_remove() and
+// linked_list_delete() go onto a LIFO free list threaded through
+// node->next instead of back to free_fptr(), so a program that keeps
+// creating and deleting lists (e.g. one queue per search) stops
+// hitting the allocator once the pool is warm. Slabs are only
+// returned by linked_list_pool_destroy().
+//
+// Like the rest of the linked_list, the pool is not thread safe.
+//
+static struct {
+    struct node_slab * slabs;      // every slab allocated, newest first
+    struct node * free_list;       // recycled nodes, most recently freed first
+    size_t slab_remaining;         // never used nodes left in slabs->nodes[]
+    size_t live_nodes;             // nodes currently owned by some linked_list
+} node_pool = { NULL, NULL, 0, 0 };
+
+// Takes a node from the pool, allocating a new slab if both the free
+// list and the current slab are exhausted.
+// Returns a node on success, NULL on allocation failure.
+//
+static struct node * node_pool_alloc(void){
+    struct node * node = node_pool.free_list;
+    if(node != NULL){
+        node_pool.free_list = node->next;
+        node_pool.live_nodes++;
+        return node;
+    }
+
+    if(node_pool.slab_remaining == 0){
+        struct node_slab * slab = (struct node_slab *)malloc_fptr(sizeof(struct node_slab));
+        if(slab == NULL){
+            return NULL;
+        }
+        slab->next               = node_pool.slabs;
+        node_pool.slabs          = slab;
+        node_pool.slab_remaining = NODE_POOL_SLAB_NODES;
+    }
+
+    //hand out the slab front to back so consecutive inserts are adjacent in memory
+    node = &node_pool.slabs->nodes[NODE_POOL_SLAB_NODES - node_pool.slab_remaining];
+    node_pool.slab_remaining--;
+    node_pool.live_nodes++;
+    return node;
+}
+
+// Returns a single node to the pool.
+// \param node : Node that is no longer linked into any linked_list.
+//
+static void node_pool_free(struct node * node){
+    node->next          = node_pool.free_list;
+    node_pool.free_list = node;
+    node_pool.live_nodes--;
+}
+
+// Returns a chain of nodes to the pool in O(1).
+// \param first : First node of the chain.
+// \param last  : Last node of the chain.
+// \param count : Number of nodes in the chain.
+//
+static void node_pool_free_chain(struct node * first, struct node * last, size_t count){
+    last->next          = node_pool.free_list;
+    node_pool.free_list = first;
+    node_pool.live_nodes -= count;
+}
+
+// Default allocator context, forwarding to the registered functions.
+//
+static void * default_alloc(void * state, size_t size){
+    (void)state;
+    return malloc_fptr(size);
+}
+
+static void default_free(void * state, void * addr){
+    (void)state;
+    free_fptr(addr);
+}
+
+static const struct allocator default_allocator = { default_alloc, default_free, NULL };
+
+// Returns TRUE if the allocator context can currently allocate. The
+// default context can't until linked_list_register_malloc() is called.
+//
+static bool allocator_can_alloc(const struct allocator * allocator){
+    return allocator->alloc != default_alloc || malloc_fptr != NULL;
+}
+
+// Returns TRUE if the allocator context can currently free.
+//
+static bool allocator_can_free(const struct allocator * allocator){
+    return allocator->free != default_free || free_fptr != NULL;
+}
+
+// Returns TRUE if nodes of ll come from the shared node pool.
+//
+static bool uses_node_pool(struct linked_list * ll){
+    return ll->allocator.alloc == default_alloc;
+}
+
+// Allocates a node for ll, from the pool or from its allocator context.
+// Returns a node on success, NULL on allocation failure.
+//
+static struct node * node_alloc(struct linked_list * ll){
+    if(uses_node_pool(ll)){
+        return node_pool_alloc();
+    }
+    return (struct node *)ll->allocator.alloc(ll->allocator.state, sizeof(struct node));
+}
+
+// Releases a single node of ll.
+//
+static void node_free(struct linked_list * ll, struct node * node){
+    if(uses_node_pool(ll)){
+        node_pool_free(node);
+        return;
+    }
+    ll->allocator.free(ll->allocator.state, node);
+}
+
+// Releases a chain of nodes of ll.
+// \param first : First node of the chain.
+// \param last  : Last node of the chain.
+// \param count : Number of nodes in the chain.
+//
+static void node_free_chain(struct linked_list * ll, struct node * first, struct node * last, size_t count){
+    if(uses_node_pool(ll)){
+        node_pool_free_chain(first, last, count);
+        return;
+    }
+    //without the pool there is no free list to splice onto, walk the chain
+    for(size_t i = 0; i < count; i++){
+        struct node * next = first->next;
+        ll->allocator.free(ll->allocator.state, first);
+        first = next;
+    }
+}
+
+// Allocates and initialises an empty linked_list.
+// Returns a new linked_list on success, NULL on failure.
+//
+static struct linked_list * linked_list_alloc(const struct allocator * allocator){
+
+    //check if the allocator can allocate
+    if(!allocator_can_alloc(allocator)){
+        return NULL;
+    }
+
+    //allocate linked_list
+    struct linked_list *ll = (struct linked_list *)allocator->alloc(allocator->state, sizeof(struct linked_list));
+
+    //exit if allocation wasn't successful
+    if(ll == NULL){
+        return NULL;
+    }
+
+    //if allocation successful, init head, tail to NULL and size to 0
+    ll->head = NULL;
+    ll->tail = NULL;
+    ll->size = 0;
+    ll->allocator = *allocator;
+    ll->finger_node  = NULL;
+    ll->finger_index = 0;
+
+    ll->storage     = LINKED_LIST_STORAGE_NODES;
+    ll->chunks      = NULL;
+    ll->chunk_index = NULL;
+    ll->chunk_count = 0;
+    ll->chunk_slots = 0;
+
+    return ll;
+}
+
+// Returns the node at index, walking from the finger when it lies at or
+// before index and from head otherwise, and leaves the finger on it.
+// PRECONDITION: index < ll->size.
+//
+static struct node * node_at(struct linked_list * ll, size_t index){
+
+    struct node * curr = ll->head;
+    size_t i = 0;
+    if(index == ll->size - 1){
+        curr = ll->tail;
+        i    = index;
+    }
+    else if(ll->finger_node != NULL && ll->finger_index <= index){
+        curr = ll->finger_node;
+        i    = ll->finger_index;
+    }
+    while(i < index){
+        curr = curr->next;
+        i++;
+    }
+
+    ll->finger_node  = curr;
+    ll->finger_index = index;
+    return curr;
+}
+
+// Allocates size bytes through the allocator context of ll.
+//
+static void * list_malloc(struct linked_list * ll, size_t size){
+    return ll->allocator.alloc(ll->allocator.state, size);
+}
+
+// Frees memory through the allocator context of ll.
+//
+static void list_free(struct linked_list * ll, void * addr){
+    ll->allocator.free(ll->allocator.state, addr);
+}
+
+// Rebuilds the Fenwick tree of an indexed list from the chunk counts,
+// in O(chunk_count).
+//
+static void chunk_index_rebuild(struct linked_list * ll){
+    size_t * tree = ll->chunk_index;
+    for(size_t i = 1; i <= ll->chunk_count; i++){
+        tree[i] = ll->chunks[i - 1]->count;
+    }
+    for(size_t i = 1; i <= ll->chunk_count; i++){
+        size_t parent = i + (i & -i);
+        if(parent <= ll->chunk_count){
+            tree[parent] += tree[i];
+        }
+    }
+}
+
+// Records a change of delta in the count of the chunk at slot.
+//
+static void chunk_index_add(struct linked_list * ll, size_t slot, ptrdiff_t delta){
+    for(size_t i = slot + 1; i <= ll->chunk_count; i += i & -i){
+        ll->chunk_index[i] += (size_t)delta;
+    }
+}
+
+// Returns the number of elements in the chunks before slot.
+//
+static size_t chunk_index_prefix(struct linked_list * ll, size_t slot){
+    size_t sum = 0;
+    for(size_t i = slot; i > 0; i -= i & -i){
+        sum += ll->chunk_index[i];
+    }
+    return sum;
+}
+
+// Records the chunk just appended at slot chunk_count - 1, in O(log n).
+//
+static void chunk_index_append(struct linked_list * ll){
+    size_t i = ll->chunk_count;
+    ll->chunk_index[i] = ll->chunks[i - 1]->count +
+                         chunk_index_prefix(ll, i - 1) -
+                         chunk_index_prefix(ll, i - (i & -i));
+}
+
+// Finds the chunk holding the element at index.
+// \param index  : Index of an element, less than ll->size.
+// \param offset : Set to the position of the element within the chunk.
+// Returns the slot of the chunk.
+//
+static size_t chunk_index_locate(struct linked_list * ll, size_t index, size_t * offset){
+    size_t step = 1;
+    while(step * 2 <= ll->chunk_count){
+        step *= 2;
+    }
+
+    //descend the tree, skipping whole subtrees that end before index
+    size_t slot = 0;
+    for(; step > 0; step /= 2){
+        if(slot + step <= ll->chunk_count && ll->chunk_index[slot + step] <= index){
+            slot  += step;
+            index -= ll->chunk_index[slot];
+        }
+    }
+
+    *offset = index;
+    return slot;
+}
+
+// Makes room in the chunk directory and tree for at least needed chunks.
+// Returns TRUE on success, FALSE otherwise. The list is unchanged on failure.
+//
+static bool chunk_directory_reserve(struct linked_list * ll, size_t needed){
+    if(needed <= ll->chunk_slots){
+        return true;
+    }
+
+    size_t slots = ll->chunk_slots > 0 ? ll->chunk_slots : 4;
+    while(slots < needed){
+        slots *= 2;
+    }
+
+    struct linked_list_chunk ** chunks = list_malloc(ll, slots * sizeof(struct linked_list_chunk *));
+    size_t * tree = list_malloc(ll, (slots + 1) * sizeof(size_t));
+    if(chunks == NULL || tree == NULL){
+        if(chunks != NULL){
+            list_free(ll, chunks);
+        }
+        if(tree != NULL){
+            list_free(ll, tree);
+        }
+        return false;
+    }
+
+    //the tree only depends on the chunk counts, not on the capacity
+    if(ll->chunks != NULL){
+        memcpy(chunks, ll->chunks, ll->chunk_count * sizeof(struct linked_list_chunk *));
+        memcpy(tree, ll->chunk_index, (ll->chunk_count + 1) * sizeof(size_t));
+        list_free(ll, ll->chunks);
+        list_free(ll, ll->chunk_index);
+    }
+    else{
+        tree[0] = 0;
+    }
+    ll->chunks      = chunks;
+    ll->chunk_index = tree;
+    ll->chunk_slots = slots;
+
+    return true;
+}
+
+// Allocates an empty chunk for ll.
+// Returns a chunk on success, NULL on allocation failure.
+//
+static struct linked_list_chunk * chunk_alloc(struct linked_list * ll){
+    struct linked_list_chunk * chunk = list_malloc(ll, sizeof(struct linked_list_chunk));
+    if(chunk != NULL){
+        chunk->count = 0;
+    }
+    return chunk;
+}
+
+// Appends an empty chunk to the directory of ll.
+// Returns the chunk on success, NULL on allocation failure.
+//
+static struct linked_list_chunk * chunk_append(struct linked_list * ll){
+    if(!chunk_directory_reserve(ll, ll->chunk_count + 1)){
+        return NULL;
+    }
+    struct linked_list_chunk * chunk = chunk_alloc(ll);
+    if(chunk == NULL){
+        return NULL;
+    }
+    ll->chunks[ll->chunk_count++] = chunk;
+    chunk_index_append(ll);
+    return chunk;
+}
+
+// Removes the chunks in slots [slot, slot + count) from the directory
+// and frees them. The caller brings the tree up to date.
+//
+static void chunk_drop(struct linked_list * ll, size_t slot, size_t count){
+    for(size_t i = slot; i < slot + count; i++){
+        list_free(ll, ll->chunks[i]);
+    }
+    memmove(ll->chunks + slot, ll->chunks + slot + count,
+            (ll->chunk_count - slot - count) * sizeof(struct linked_list_chunk *));
+    ll->chunk_count -= count;
+}
+
+// Inserts data at index of an indexed list.
+// Returns TRUE on success, FALSE otherwise.
+//
+static bool indexed_insert(struct linked_list * ll, size_t index, unsigned int data){
+    size_t slot;
+    size_t offset;
+    struct linked_list_chunk * chunk;
+
+    if(index == ll->size){
+        //appending only needs a new chunk once the last one is full
+        if(ll->chunk_count == 0 || ll->chunks[ll->chunk_count - 1]->count == LINKED_LIST_CHUNK_CAPACITY){
+            if(chunk_append(ll) == NULL){
+                return false;
+            }
+        }
+        slot   = ll->chunk_count - 1;
+        chunk  = ll->chunks[slot];
+        offset = chunk->count;
+    }
+    else{
+        slot  = chunk_index_locate(ll, index, &offset);
+        chunk = ll->chunks[slot];
+    }
+
+    if(chunk->count < LINKED_LIST_CHUNK_CAPACITY){
+        memmove(chunk->data + offset + 1, chunk->data + offset,
+                (chunk->count - offset) * sizeof(unsigned int));
+        chunk->data[offset] = data;
+        chunk->count++;
+        ll->size++;
+        chunk_index_add(ll, slot, 1);
+        return true;
+    }
+
+    //chunk is full, split it in half and insert into the matching half
+    if(!chunk_directory_reserve(ll, ll->chunk_count + 1)){
+        return false;
+    }
+    struct linked_list_chunk * upper = chunk_alloc(ll);
+    if(upper == NULL){
+        return false;
+    }
+    size_t half  = LINKED_LIST_CHUNK_CAPACITY / 2;
+    upper->count = LINKED_LIST_CHUNK_CAPACITY - half;
+    memcpy(upper->data, chunk->data + half, upper->count * sizeof(unsigned int));
+    chunk->count = half;
+    memmove(ll->chunks + slot + 2, ll->chunks + slot + 1,
+            (ll->chunk_count - slot - 1) * sizeof(struct linked_list_chunk *));
+    ll->chunks[slot + 1] = upper;
+    ll->chunk_count++;
+
+    if(offset > half){
+        chunk   = upper;
+        offset -= half;
+    }
+    memmove(chunk->data + offset + 1, chunk->data + offset,
+            (chunk->count - offset) * sizeof(unsigned int));
+    chunk->data[offset] = data;
+    chunk->count++;
+    ll->size++;
+    chunk_index_rebuild(ll);
+
+    return true;
+}
+
+// Removes the element at index of an indexed list.
+// \param out : Set to the removed data, unless NULL.
+//
+static void indexed_remove(struct linked_list * ll, size_t index, unsigned int * out){
+    size_t offset;
+    size_t slot = chunk_index_locate(ll, index, &offset);
+    struct linked_list_chunk * chunk = ll->chunks[slot];
+
+    if(out != NULL){
+        *out = chunk->data[offset];
+    }
+    memmove(chunk->data + offset, chunk->data + offset + 1,
+            (chunk->count - offset - 1) * sizeof(unsigned int));
+    chunk->count--;
+    ll->size--;
+
+    if(chunk->count == 0){
+        chunk_drop(ll, slot, 1);
+        //tree entries up to a slot only cover chunks before it, so
+        //dropping the last chunk leaves the rest of the tree intact
+        if(slot != ll->chunk_count){
+            chunk_index_rebuild(ll);
+        }
+        return;
+    }
+
+    //fold a mostly empty chunk into its neighbour so chunks stay dense
+    if(slot + 1 < ll->chunk_count &&
+       chunk->count + ll->chunks[slot + 1]->count <= LINKED_LIST_CHUNK_CAPACITY / 2){
+        struct linked_list_chunk * next = ll->chunks[slot + 1];
+        memcpy(chunk->data + chunk->count, next->data, next->count * sizeof(unsigned int));
+        chunk->count += next->count;
+        next->count   = 0;
+        chunk_drop(ll, slot + 1, 1);
+        chunk_index_rebuild(ll);
+        return;
+    }
+
+    chunk_index_add(ll, slot, -1);
+}
+
+// Kernels used by linked_list_find() and linked_list_count() to scan
+// the elements of a chunk. On x86 the SSE2 (always present on x86-64)
+// or AVX2 versions are picked at run time, elsewhere the scalar ones
+// are used.
+//
+// Returns the position of the first element of data[0 .. n) equal to
+// value, n if there is none.
+//
+static size_t scan_find_scalar(const unsigned int * data, size_t n, unsigned int value){
+    for(size_t i = 0; i < n; i++){
+        if(data[i] == value){
+            return i;
+        }
+    }
+    return n;
+}
+
+// Returns the number of elements of data[0 .. n) equal to value.
+//
+static size_t scan_count_scalar(const unsigned int * data, size_t n, unsigned int value){
+    size_t count = 0;
+    for(size_t i = 0; i < n; i++){
+        count += data[i] == value;
+    }
+    return count;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse2")))
+static size_t scan_find_sse2(const unsigned int * data, size_t n, unsigned int value){
+    __m128i needle = _mm_set1_epi32((int)value);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4){
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        if(mask != 0){
+            return i + (size_t)__builtin_ctz((unsigned int)mask);
+        }
+    }
+    return i + scan_find_scalar(data + i, n - i, value);
+}
+
+__attribute__((target("sse2")))
+static size_t scan_count_sse2(const unsigned int * data, size_t n, unsigned int value){
+    __m128i needle = _mm_set1_epi32((int)value);
+    __m128i total  = _mm_setzero_si128();
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4){
+        __m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+        //a match compares as -1, so subtracting counts it
+        total = _mm_sub_epi32(total, _mm_cmpeq_epi32(block, needle));
+    }
+    unsigned int lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, total);
+    return (size_t)lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+           scan_count_scalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_find_avx2(const unsigned int * data, size_t n, unsigned int value){
+    __m256i needle = _mm256_set1_epi32((int)value);
+    size_t i = 0;
+    for(; i + 16 <= n; i += 16){
+        __m256i lo = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(data + i)), needle);
+        __m256i hi = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(data + i + 8)), needle);
+        if(!_mm256_testz_si256(_mm256_or_si256(lo, hi), _mm256_or_si256(lo, hi))){
+            unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(lo)) |
+                                (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(hi)) << 8;
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return i + scan_find_scalar(data + i, n - i, value);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_count_avx2(const unsigned int * data, size_t n, unsigned int value){
+    __m256i needle = _mm256_set1_epi32((int)value);
+    __m256i total  = _mm256_setzero_si256();
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8){
+        __m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+        total = _mm256_sub_epi32(total, _mm256_cmpeq_epi32(block, needle));
+    }
+    unsigned int lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, total);
+    size_t count = 0;
+    for(size_t lane = 0; lane < 8; lane++){
+        count += lanes[lane];
+    }
+    return count + scan_count_scalar(data + i, n - i, value);
+}
+
+#endif
+
+// Kernels picked by scan_select(). The scalar ones are safe defaults
+// for any code that runs before it.
+//
+static size_t (*scan_find)(const unsigned int *, size_t, unsigned int)  = scan_find_scalar;
+static size_t (*scan_count)(const unsigned int *, size_t, unsigned int) = scan_count_scalar;
+
+// Picks the widest kernels the CPU supports, once, when the library
+// is loaded.
+//
+__attribute__((constructor))
+static void scan_select(void){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        scan_count = scan_count_avx2;
+        scan_find  = scan_find_avx2;
+        return;
+    }
+    if(__builtin_cpu_supports("sse2")){
+        scan_count = scan_count_sse2;
+        scan_find  = scan_find_sse2;
+        return;
+    }
+#endif
+    scan_count = scan_count_scalar;
+    scan_find  = scan_find_scalar;
+}
+
+// Returns the index of the first element of an indexed list equal to
+// data, SIZE_MAX if there is none.
+//
+static size_t indexed_find(struct linked_list * ll, unsigned int data){
+    size_t base = 0;
+    for(size_t slot = 0; slot < ll->chunk_count; slot++){
+        struct linked_list_chunk * chunk = ll->chunks[slot];
+        size_t i = scan_find(chunk->data, chunk->count, data);
+        if(i < chunk->count){
+            return base + i;
+        }
+        base += chunk->count;
+    }
+    return SIZE_MAX;
+}
+
+// Appends n elements to an indexed list. Every chunk that will be
+// needed is allocated before anything is copied in.
+// Returns TRUE on success, FALSE otherwise. The list is unchanged on failure.
+//
+static bool indexed_insert_end_bulk(struct linked_list * ll, const unsigned int * data, size_t n){
+    size_t room = 0;
+    if(ll->chunk_count > 0){
+        room = LINKED_LIST_CHUNK_CAPACITY - ll->chunks[ll->chunk_count - 1]->count;
+    }
+    size_t fresh = n > room ? (n - room + LINKED_LIST_CHUNK_CAPACITY - 1) / LINKED_LIST_CHUNK_CAPACITY : 0;
+
+    //park the new chunks past chunk_count until all of them exist
+    if(!chunk_directory_reserve(ll, ll->chunk_count + fresh)){
+        return false;
+    }
+    for(size_t i = 0; i < fresh; i++){
+        struct linked_list_chunk * chunk = chunk_alloc(ll);
+        if(chunk == NULL){
+            for(size_t j = 0; j < i; j++){
+                list_free(ll, ll->chunks[ll->chunk_count + j]);
+            }
+            return false;
+        }
+        ll->chunks[ll->chunk_count + i] = chunk;
+    }
+
+    size_t copied = n < room ? n : room;
+    if(copied > 0){
+        struct linked_list_chunk * last = ll->chunks[ll->chunk_count - 1];
+        memcpy(last->data + last->count, data, copied * sizeof(unsigned int));
+        last->count += copied;
+        chunk_index_add(ll, ll->chunk_count - 1, (ptrdiff_t)copied);
+    }
+    for(size_t i = 0; i < fresh; i++){
+        struct linked_list_chunk * chunk = ll->chunks[ll->chunk_count];
+        size_t count = n - copied < LINKED_LIST_CHUNK_CAPACITY ? n - copied : LINKED_LIST_CHUNK_CAPACITY;
+        memcpy(chunk->data, data + copied, count * sizeof(unsigned int));
+        chunk->count = count;
+        copied += count;
+        ll->chunk_count++;
+        chunk_index_append(ll);
+    }
+    ll->size += n;
+
+    return true;
+}
+
+// Removes the first n elements of an indexed list into out.
+// \param n : Number of elements to remove, at most ll->size.
+//
+static void indexed_remove_front_bulk(struct linked_list * ll, unsigned int * out, size_t n){
+    size_t copied  = 0;
+    size_t drained = 0;
+    while(copied < n){
+        struct linked_list_chunk * chunk = ll->chunks[drained];
+        size_t take = n - copied < chunk->count ? n - copied : chunk->count;
+        memcpy(out + copied, chunk->data, take * sizeof(unsigned int));
+        copied += take;
+        if(take < chunk->count){
+            memmove(chunk->data, chunk->data + take, (chunk->count - take) * sizeof(unsigned int));
+            chunk->count -= take;
+            break;
+        }
+        chunk->count = 0;
+        drained++;
+    }
+    ll->size -= n;
+
+    if(drained > 0){
+        chunk_drop(ll, 0, drained);
+        chunk_index_rebuild(ll);
+    }
+    else{
+        chunk_index_add(ll, 0, -(ptrdiff_t)n);
+    }
+}
+
+// Number of pending runs node_merge_sort() can hold. Run i has 2^i
+// nodes, so this covers any list that fits in memory.
+//
+#define NODE_SORT_RUNS 64
+
+// Merges two sorted chains, taking from a on ties so that the merge is
+// stable. a_tail and b_tail are the last nodes of a and b.
+// \param tail : Set to the last node of the merged chain.
+// Returns the first node of the merged chain.
+//
+static struct node * node_chain_merge(struct node * a, struct node * a_tail,
+                                      struct node * b, struct node * b_tail,
+                                      struct node ** tail){
+    struct node head;
+    struct node * last = &head;
+    while(a != NULL && b != NULL){
+        if(b->data < a->data){
+            last->next = b;
+            last = b;
+            b = b->next;
+        }
+        else{
+            last->next = a;
+            last = a;
+            a = a->next;
+        }
+    }
+    //whichever chain is left over finishes the merge
+    if(a != NULL){
+        last->next = a;
+        *tail = a_tail;
+    }
+    else{
+        last->next = b;
+        *tail = b != NULL ? b_tail : last;
+    }
+    return head.next;
+}
+
+// Sorts a node list with a bottom-up merge sort that merges runs as
+// soon as two of the same length exist, like a binary counter: run i
+// of the pending runs holds 2^i nodes or nothing. Merging while the
+// nodes involved are still in cache is much faster than a pass over the
+// whole list per run length. Stable, O(n log n), and no memory beyond
+// the fixed table of pending runs.
+//
+static void node_merge_sort(struct linked_list * ll){
+    struct node * runs[NODE_SORT_RUNS];
+    struct node * run_tails[NODE_SORT_RUNS];
+    size_t used = 0;
+
+    struct node * curr = ll->head;
+    while(curr != NULL){
+        //take the next node as a run of one
+        struct node * run      = curr;
+        struct node * run_tail = curr;
+        curr = curr->next;
+        run->next = NULL;
+
+        //carry it up through the occupied runs, earlier nodes first
+        size_t i = 0;
+        for(; i < used && runs[i] != NULL; i++){
+            run = node_chain_merge(runs[i], run_tails[i], run, run_tail, &run_tail);
+            runs[i] = NULL;
+        }
+        if(i == used){
+            used++;
+        }
+        runs[i]      = run;
+        run_tails[i] = run_tail;
+    }
+
+    //merge what is pending, longer runs hold earlier nodes
+    struct node * run      = NULL;
+    struct node * run_tail = NULL;
+    for(size_t i = 0; i < used; i++){
+        if(runs[i] == NULL){
+            continue;
+        }
+        if(run == NULL){
+            run      = runs[i];
+            run_tail = run_tails[i];
+        }
+        else{
+            run = node_chain_merge(runs[i], run_tails[i], run, run_tail, &run_tail);
+        }
+    }
+    ll->head = run;
+    ll->tail = run_tail;
+}
+
+// Slides the elements of an indexed list down across chunk boundaries,
+// dropping those that match predicate, so the list ends up packed into
+// full chunks with only the last one partly filled. Afterwards the
+// element at index lives at chunks[index / C]->data[index % C]. A NULL
+// predicate keeps everything.
+// Returns the number of elements removed.
+//
+static size_t indexed_compact(struct linked_list * ll,
+                              bool (*predicate)(unsigned int data, void * ctx),
+                              void * ctx){
+    size_t removed      = 0;
+    size_t write_slot   = 0;
+    size_t write_offset = 0;
+    for(size_t slot = 0; slot < ll->chunk_count; slot++){
+        struct linked_list_chunk * chunk = ll->chunks[slot];
+        size_t count = chunk->count;
+        for(size_t i = 0; i < count; i++){
+            unsigned int data = chunk->data[i];
+            if(predicate != NULL && predicate(data, ctx)){
+                removed++;
+                continue;
+            }
+            ll->chunks[write_slot]->data[write_offset++] = data;
+            if(write_offset == LINKED_LIST_CHUNK_CAPACITY){
+                ll->chunks[write_slot++]->count = write_offset;
+                write_offset = 0;
+            }
+        }
+    }
+    if(write_offset > 0){
+        ll->chunks[write_slot++]->count = write_offset;
+    }
+
+    //free the chunks left over at the end
+    chunk_drop(ll, write_slot, ll->chunk_count - write_slot);
+    chunk_index_rebuild(ll);
+    ll->size -= removed;
+    return removed;
+}
+
+// Returns the element at index of a packed indexed list, see
+// indexed_compact().
+//
+static unsigned int * indexed_packed_at(struct linked_list * ll, size_t index){
+    return &ll->chunks[index / LINKED_LIST_CHUNK_CAPACITY]->data[index % LINKED_LIST_CHUNK_CAPACITY];
+}
+
+// Restores the max-heap property below root, for heaps of n elements
+// laid over a packed indexed list.
+//
+static void indexed_sift_down(struct linked_list * ll, size_t root, size_t n){
+    unsigned int value = *indexed_packed_at(ll, root);
+    for(;;){
+        size_t child = 2 * root + 1;
+        if(child >= n){
+            break;
+        }
+        if(child + 1 < n && *indexed_packed_at(ll, child + 1) > *indexed_packed_at(ll, child)){
+            child++;
+        }
+        unsigned int larger = *indexed_packed_at(ll, child);
+        if(larger <= value){
+            break;
+        }
+        *indexed_packed_at(ll, root) = larger;
+        root = child;
+    }
+    *indexed_packed_at(ll, root) = value;
+}
+
+// Sorts an indexed list in place with heapsort: O(n log n) and no
+// memory beyond the chunks already held.
+//
+static void indexed_sort(struct linked_list * ll){
+    indexed_compact(ll, NULL, NULL);
+    size_t n = ll->size;
+    for(size_t root = n / 2; root-- > 0;){
+        indexed_sift_down(ll, root, n);
+    }
+    for(size_t end = n - 1; end > 0; end--){
+        unsigned int * last = indexed_packed_at(ll, end);
+        unsigned int top    = *indexed_packed_at(ll, 0);
+        *indexed_packed_at(ll, 0) = *last;
+        *last = top;
+        indexed_sift_down(ll, 0, end);
+    }
+}
+
+// Radix sort digits of indexed lists: 8 bits at a time, least
+// significant first.
 //
-static void * (*malloc_fptr)(size_t size) = NULL;
-static void   (*free_fptr)(void* addr)    = NULL; 
+#define RADIX_BITS    8
+#define RADIX_BUCKETS (1u << RADIX_BITS)
+#define RADIX_PASSES  ((sizeof(unsigned int) * 8) / RADIX_BITS)
+
+// Node lists use wider digits. Every pass walks the nodes in whatever
+// order the previous pass left them, a cache miss per node, so one pass
+// fewer matters more than the bigger bucket table.
+//
+#define NODE_RADIX_BITS    11
+#define NODE_RADIX_BUCKETS (1u << NODE_RADIX_BITS)
+#define NODE_RADIX_PASSES  ((sizeof(unsigned int) * 8 + NODE_RADIX_BITS - 1) / NODE_RADIX_BITS)
+
+// Returns the bits in which the elements of a node list differ, so
+// passes over digits that are equal everywhere can be skipped.
+//
+static unsigned int node_differing_bits(struct linked_list * ll){
+    unsigned int all_set = UINT_MAX;
+    unsigned int any_set = 0;
+    for(struct node * curr = ll->head; curr != NULL; curr = curr->next){
+        all_set &= curr->data;
+        any_set |= curr->data;
+    }
+    return all_set ^ any_set;
+}
+
+// Sorts a node list with an LSD radix sort that relinks the nodes into
+// one bucket per digit value on every pass. Stable, O(n) per pass, and
+// the buckets are the only extra memory.
+//
+static void node_radix_sort(struct linked_list * ll){
+    unsigned int differing = node_differing_bits(ll);
+    struct node * heads[NODE_RADIX_BUCKETS];
+    struct node * tails[NODE_RADIX_BUCKETS];
+    for(unsigned int pass = 0; pass < NODE_RADIX_PASSES; pass++){
+        unsigned int shift = pass * NODE_RADIX_BITS;
+        if(((differing >> shift) & (NODE_RADIX_BUCKETS - 1)) == 0){
+            continue;
+        }
+
+        //deal the nodes into buckets, keeping their order within a bucket
+        memset(heads, 0, sizeof(heads));
+        for(struct node * curr = ll->head; curr != NULL; curr = curr->next){
+            unsigned int digit = (curr->data >> shift) & (NODE_RADIX_BUCKETS - 1);
+            if(heads[digit] == NULL){
+                heads[digit] = curr;
+            }
+            else{
+                tails[digit]->next = curr;
+            }
+            tails[digit] = curr;
+        }
+
+        //and chain the buckets back together in digit order
+        struct node * tail = NULL;
+        for(unsigned int digit = 0; digit < NODE_RADIX_BUCKETS; digit++){
+            if(heads[digit] == NULL){
+                continue;
+            }
+            if(tail == NULL){
+                ll->head = heads[digit];
+            }
+            else{
+                tail->next = heads[digit];
+            }
+            tail = tails[digit];
+        }
+        tail->next = NULL;
+        ll->tail   = tail;
+    }
+}
+
+// Sorts an indexed list with an LSD radix sort, bouncing the elements
+// between the packed chunks and one scratch array of n elements.
+// Returns TRUE on success, FALSE if the scratch array can't be had.
+//
+static bool indexed_radix_sort(struct linked_list * ll){
+    size_t n = ll->size;
+    unsigned int * scratch = list_malloc(ll, n * sizeof(unsigned int));
+    if(scratch == NULL){
+        return false;
+    }
+    indexed_compact(ll, NULL, NULL);
+
+    //one read to histogram every digit at once
+    size_t counts[RADIX_PASSES][RADIX_BUCKETS];
+    memset(counts, 0, sizeof(counts));
+    for(size_t slot = 0; slot < ll->chunk_count; slot++){
+        struct linked_list_chunk * chunk = ll->chunks[slot];
+        for(size_t i = 0; i < chunk->count; i++){
+            for(unsigned int pass = 0; pass < RADIX_PASSES; pass++){
+                counts[pass][(chunk->data[i] >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+            }
+        }
+    }
+
+    bool in_scratch = false;
+    for(unsigned int pass = 0; pass < RADIX_PASSES; pass++){
+        unsigned int shift = pass * RADIX_BITS;
+        //a digit shared by every element doesn't reorder anything
+        bool uniform = false;
+        size_t offsets[RADIX_BUCKETS];
+        size_t offset = 0;
+        for(unsigned int digit = 0; digit < RADIX_BUCKETS; digit++){
+            uniform |= counts[pass][digit] == n;
+            offsets[digit] = offset;
+            offset += counts[pass][digit];
+        }
+        if(uniform){
+            continue;
+        }
 
-// (void)(malloc_fptr);
-// (void)(free_fptr);
+        for(size_t i = 0; i < n; i++){
+            unsigned int data  = in_scratch ? scratch[i] : *indexed_packed_at(ll, i);
+            unsigned int digit = (data >> shift) & (RADIX_BUCKETS - 1);
+            if(in_scratch){
+                *indexed_packed_at(ll, offsets[digit]++) = data;
+            }
+            else{
+                scratch[offsets[digit]++] = data;
+            }
+        }
+        in_scratch = !in_scratch;
+    }
+
+    //an odd number of passes leaves the result in the scratch array
+    if(in_scratch){
+        for(size_t slot = 0; slot < ll->chunk_count; slot++){
+            memcpy(ll->chunks[slot]->data, scratch + slot * LINKED_LIST_CHUNK_CAPACITY,
+                   ll->chunks[slot]->count * sizeof(unsigned int));
+        }
+    }
 
+    list_free(ll, scratch);
+    return true;
+}
 
+// Points iter at the element at index of an indexed list.
+//
+static void indexed_position(struct linked_list * ll, size_t index, struct iterator * iter){
+    size_t offset;
+    size_t slot = chunk_index_locate(ll, index, &offset);
+    iter->ll            = ll;
+    iter->current_node  = NULL;
+    iter->current_index = index;
+    iter->chunk_slot    = slot;
+    iter->chunk_offset  = offset;
+    iter->data          = ll->chunks[slot]->data[offset];
+}
 
 // Creates a new linked_list.
 // PRECONDITION: Register malloc() and free() functions via the
@@ -44,24 +1068,39 @@ static void   (*free_fptr)(void* addr)    = NULL;
 // Returns a new linked_list on success, NULL on failure.
 //
 struct linked_list * linked_list_create(void){
+    return linked_list_alloc(&default_allocator);
+}
+
+// Creates a new linked_list that allocates through its own allocator
+// context.
+// \param allocator : Allocator context, copied into the linked_list.
+// Returns a new linked_list on success, NULL on failure.
+//
+struct linked_list * linked_list_create_with_allocator(const struct allocator * allocator){
 
-    //check if malloc_fptr is NULL
-    if(malloc_fptr == NULL){
+    //check if input is NULL or incomplete
+    if(allocator == NULL || allocator->alloc == NULL || allocator->free == NULL){
         return NULL;
     }
 
-    //allocate linked_list
-    struct linked_list *ll = (struct linked_list *)malloc_fptr(sizeof(struct linked_list));
+    return linked_list_alloc(allocator);
+}
 
-    //exit if allocation wasn't successful
-    if(ll == NULL){
+// Creates a new linked_list with indexed storage.
+// Returns a new linked_list on success, NULL on failure.
+//
+struct linked_list * linked_list_create_indexed(void){
+
+    //chunks are freed one by one, so free() has to be there too
+    if(free_fptr == NULL){
         return NULL;
     }
 
-    //if allocation successful, init head, tail to NULL and size to 0
-    ll->head = NULL;
-    ll->tail = NULL;
-    ll->size = 0;
+    struct linked_list * ll = linked_list_alloc(&default_allocator);
+    if(ll == NULL){
+        return NULL;
+    }
+    ll->storage = LINKED_LIST_STORAGE_INDEXED;
 
     return ll;
 }
@@ -72,27 +1111,30 @@ struct linked_list * linked_list_create(void){
 //
 bool linked_list_delete(struct linked_list * ll){
 
-    //check if input is NULL and free_fptr is NULL
-    if(ll == NULL || free_fptr == NULL){
+    //check if input is NULL and the allocator can't free
+    if(ll == NULL || !allocator_can_free(&ll->allocator)){
         return false;
     }
 
-    //create pointers to head and next nodes
-    //and free each node by iterating
-    //through the entire list
-    struct node* curr = ll->head;
-    struct node* next = NULL;
-    while(curr != NULL){
-        //store next node
-        next = curr->next;
-        //free curr node
-        free_fptr(curr);
-        //traverse to next
-        curr = next;
+    //free the chunks and their directory
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        for(size_t i = 0; i < ll->chunk_count; i++){
+            list_free(ll, ll->chunks[i]);
+        }
+        if(ll->chunks != NULL){
+            list_free(ll, ll->chunks);
+            list_free(ll, ll->chunk_index);
+        }
+    }
+
+    //hand every node back, to the pool this is a single step
+    if(ll->head != NULL){
+        node_free_chain(ll, ll->head, ll->tail, ll->size);
     }
 
     //finally, free the linked_list
-    free_fptr(ll);
+    struct allocator allocator = ll->allocator;
+    allocator.free(allocator.state, ll);
 
     return true;
 }
@@ -121,13 +1163,16 @@ size_t linked_list_size(struct linked_list * ll){
 bool linked_list_insert_end(struct linked_list * ll,
                             unsigned int data){
 
-    //check if input is NULL and malloc_fptr is NULL
-    if(ll == NULL || malloc_fptr == NULL){
+    //check if input is NULL and the allocator can't allocate
+    if(ll == NULL || !allocator_can_alloc(&ll->allocator)){
         return false;
     }
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        return indexed_insert(ll, ll->size, data);
+    }
 
     //create new node
-    struct node* new_node = (struct node*)malloc_fptr(sizeof(struct node));
+    struct node* new_node = node_alloc(ll);
     //exit if allocation wasn't successful
     if(new_node == NULL){
         return false;
@@ -156,6 +1201,61 @@ bool linked_list_insert_end(struct linked_list * ll,
     return true;
 }
 
+// Inserts an array of elements at the end of the linked_list, in order.
+// \param ll   : Pointer to linked_list.
+// \param data : Data to insert.
+// \param n    : Number of elements in data.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_insert_end_bulk(struct linked_list * ll,
+                                 const unsigned int * data,
+                                 size_t n){
+
+    //check if input is NULL and the allocator can't allocate
+    if(ll == NULL || !allocator_can_alloc(&ll->allocator) || (data == NULL && n > 0)){
+        return false;
+    }
+    if(n == 0){
+        return true;
+    }
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        return indexed_insert_end_bulk(ll, data, n);
+    }
+
+    //build the new nodes as a detached chain first, so that running
+    //out of memory part way leaves the linked_list untouched
+    struct node* first = node_alloc(ll);
+    if(first == NULL){
+        return false;
+    }
+    first->data = data[0];
+    struct node* last = first;
+    for(size_t i = 1; i < n; i++){
+        struct node* new_node = node_alloc(ll);
+        if(new_node == NULL){
+            last->next = NULL;
+            node_free_chain(ll, first, last, i);
+            return false;
+        }
+        new_node->data = data[i];
+        last->next = new_node;
+        last = new_node;
+    }
+    last->next = NULL;
+
+    //link the chain in after the current tail
+    if(ll->tail == NULL){
+        ll->head = first;
+    }
+    else{
+        ll->tail->next = first;
+    }
+    ll->tail = last;
+    ll->size += n;
+
+    return true;
+}
+
 // Inserts an element at the front of the linked_list.
 // \param ll   : Pointer to linked_list.
 // \param data : Data to insert.
@@ -164,13 +1264,16 @@ bool linked_list_insert_end(struct linked_list * ll,
 bool linked_list_insert_front(struct linked_list * ll,
                               unsigned int data){
 
-    //check if input is NULL and malloc_fptr is NULL
-    if(ll == NULL || malloc_fptr == NULL){
+    //check if input is NULL and the allocator can't allocate
+    if(ll == NULL || !allocator_can_alloc(&ll->allocator)){
         return false;
     }
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        return indexed_insert(ll, 0, data);
+    }
 
     //create new node
-    struct node* new_node = (struct node*)malloc_fptr(sizeof(struct node));
+    struct node* new_node = node_alloc(ll);
     //exit if allocation wasn't successful
     if(new_node == NULL){
         return false;
@@ -193,6 +1296,9 @@ bool linked_list_insert_front(struct linked_list * ll,
         ll->head = new_node;
     }
 
+    //every index has moved up by one
+    ll->finger_node = NULL;
+
     //increment linked_list size
     ll->size++;
 
@@ -209,10 +1315,13 @@ bool linked_list_insert(struct linked_list * ll,
                         size_t index,
                         unsigned int data){
 
-    //check if input is NULLx malloc_fptr/free_fptr are NULL or if index is > linked_list size
-    if(ll == NULL || malloc_fptr == NULL || free_fptr == NULL || index > ll->size){
+    //check if input is NULL, the allocator isn't usable or if index is > linked_list size
+    if(ll == NULL || !allocator_can_alloc(&ll->allocator) || !allocator_can_free(&ll->allocator) || index > ll->size){
         return false;
     }
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        return indexed_insert(ll, index, data);
+    }
     //if index to be inserted is at front, use linked_list_insert_front
     if(index == 0){
         return linked_list_insert_front(ll, data);
@@ -222,21 +1331,10 @@ bool linked_list_insert(struct linked_list * ll,
          return linked_list_insert_end(ll, data);
     }
 
-    //create an iterator and populate it
-    struct iterator iter;
-    if(__linked_list_populate_iterator(ll, 0, &iter) == false){
-        return false;
-    }
-
-    //iterate to the previous node of the index element i.e. to index - 1
-    while(linked_list_iterate(&iter) && iter.current_index < index - 1){
-
-    }
-
-    //curr points to the previous node of the node to be deleted
-    struct node* curr = iter.current_node;
+    //curr points to the node before index i.e. to index - 1
+    struct node* curr = node_at(ll, index - 1);
     //create new node
-    struct node* new_node = (struct node*)malloc_fptr(sizeof(struct node));
+    struct node* new_node = node_alloc(ll);
     //exit if allocation wasn't successful
     if(new_node == NULL){
         return false;
@@ -247,6 +1345,9 @@ bool linked_list_insert(struct linked_list * ll,
     new_node->next = curr->next;
     //set curr->next to new_node
     curr->next = new_node; //missed this
+    //leave the finger on the new node so index + 1 is one step away
+    ll->finger_node  = new_node;
+    ll->finger_index = index;
     //increase linked_list size
     ll->size++;
 
@@ -265,29 +1366,48 @@ size_t linked_list_find(struct linked_list * ll,
     if(ll == NULL){
         return SIZE_MAX;
     }
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        return indexed_find(ll, data);
+    }
 
-    //create an iterator and populate it
-    struct iterator iter;
-    if(__linked_list_populate_iterator(ll, 0, &iter) == false){
-        return SIZE_MAX;
+    //walk the nodes directly, one check per node
+    size_t index = 0;
+    for(struct node * curr = ll->head; curr != NULL; curr = curr->next){
+        if(curr->data == data){
+            return index;
+        }
+        index++;
     }
 
-    //if first element is the data, then return
-    if(iter.data == data){
-        size_t curr_idx = iter.current_index;
-        return curr_idx;
+    //no match found so return SIZE_MAX
+    return SIZE_MAX;
+}
+
+// Counts the elements equal to data.
+// \param ll   : Pointer to linked_list.
+// \param data : Data to count.
+// Returns the number of matches on success, SIZE_MAX on failure.
+//
+size_t linked_list_count(struct linked_list * ll,
+                         unsigned int data){
+
+    //if input is NULL then return SIZE_MAX
+    if(ll == NULL){
+        return SIZE_MAX;
     }
 
-    //iterate till we find the first occurence if its not the first element
-    while(linked_list_iterate(&iter)){
-        if(iter.data == data){
-            size_t curr_idx = iter.current_index;
-            return curr_idx;
+    size_t count = 0;
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        for(size_t slot = 0; slot < ll->chunk_count; slot++){
+            count += scan_count(ll->chunks[slot]->data, ll->chunks[slot]->count, data);
         }
+        return count;
     }
 
-    //no match found so return SIZE_MAX
-    return SIZE_MAX;
+    for(struct node * curr = ll->head; curr != NULL; curr = curr->next){
+        count += curr->data == data;
+    }
+    return count;
 }
 
 // Removes a node from the linked_list at a specific index.
@@ -298,25 +1418,31 @@ size_t linked_list_find(struct linked_list * ll,
 bool linked_list_remove(struct linked_list * ll,
                         size_t index){
 
-    //check if input is NULL or if free_fptr is NULL or if index to be removed
-    //is greater than or equal to current linked_list size
-    if(ll == NULL || free_fptr == NULL || index >= ll->size){
+    //check if input is NULL or if the allocator can't free or if index to be
+    //removed is greater than or equal to current linked_list size
+    if(ll == NULL || !allocator_can_free(&ll->allocator) || index >= ll->size){
         return false;
     }
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        indexed_remove(ll, index, NULL);
+        return true;
+    }
 
     //if index to be removed is the first
     if(index == 0){
         struct node* curr = ll->head;
+        //the finger may be on the removed node, drop it
+        ll->finger_node = NULL;
         //edge case: only one element
         if(ll->size == 1){
-            free_fptr(curr);
+            node_free(ll, curr);
             ll->head = NULL;
             ll->tail = NULL;
         }
         else{
             //point head to the next node
             ll->head = ll->head->next;
-            free_fptr(curr);
+            node_free(ll, curr);
         }
 
         //decrement counter
@@ -325,19 +1451,9 @@ bool linked_list_remove(struct linked_list * ll,
         return true;
     }
 
-    //create an iterator and populate it
-    struct iterator iter;
-    if(__linked_list_populate_iterator(ll, 0, &iter) == false){
-        return false;
-    }
-
-    //iterate to the previous node of the index element i.e. to index - 1
-    while(linked_list_iterate(&iter) && iter.current_index < index - 1){
-
-    }
-
-    //point curr to the previous node of index i.e. index - 1
-    struct node* curr = iter.current_node;
+    //point curr to the previous node of index i.e. index - 1, the finger
+    //stays on it and remains valid
+    struct node* curr = node_at(ll, index - 1);
     //point toBeDeteled to the node to be deleted at index
     struct node* toBeDeteled = curr->next;
     //handle edge case where node to be deleted is tail
@@ -352,13 +1468,217 @@ bool linked_list_remove(struct linked_list * ll,
 
 
     //free the node to be deleted
-    free_fptr(toBeDeteled);
+    node_free(ll, toBeDeteled);
     //decrement size
     ll->size--;
 
     return true;
 }
 
+// Removes up to max elements from the front of the linked_list, copying
+// their data out in order.
+// \param ll      : Pointer to linked_list.
+// \param out     : Buffer for the removed data (provided by caller).
+// \param max     : Maximum number of elements to remove.
+// \param removed : Pointer to the number of elements removed.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_remove_front_bulk(struct linked_list * ll,
+                                   unsigned int * out,
+                                   size_t max,
+                                   size_t * removed){
+
+    if(removed != NULL){
+        *removed = 0;
+    }
+    //check if input is NULL or if there is nothing to remove
+    if(ll == NULL || out == NULL || removed == NULL || ll->size == 0 || max == 0){
+        return false;
+    }
+
+    size_t n = max < ll->size ? max : ll->size;
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        indexed_remove_front_bulk(ll, out, n);
+        *removed = n;
+        return true;
+    }
+
+    //copy the data out while walking to the last node being removed
+    struct node* first = ll->head;
+    struct node* last  = first;
+    out[0] = first->data;
+    for(size_t i = 1; i < n; i++){
+        last   = last->next;
+        out[i] = last->data;
+    }
+
+    //unlink the whole run and recycle it in one step
+    ll->finger_node = NULL;
+    ll->head = last->next;
+    if(ll->head == NULL){
+        ll->tail = NULL;
+    }
+    ll->size -= n;
+    node_free_chain(ll, first, last, n);
+
+    *removed = n;
+    return true;
+}
+
+// Removes every element for which predicate returns TRUE.
+// \param ll        : Pointer to linked_list.
+// \param predicate : Function called with each element and ctx.
+// \param ctx       : Opaque pointer handed to predicate.
+// Returns the number of elements removed on success, SIZE_MAX on failure.
+//
+size_t linked_list_remove_if(struct linked_list * ll,
+                             bool (*predicate)(unsigned int data, void * ctx),
+                             void * ctx){
+
+    //check if input is NULL or if the allocator can't free
+    if(ll == NULL || predicate == NULL || !allocator_can_free(&ll->allocator)){
+        return SIZE_MAX;
+    }
+
+    size_t removed = 0;
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        return indexed_compact(ll, predicate, ctx);
+    }
+
+    //unlink matches while walking, chaining them up for a single release
+    struct node * prev  = NULL;
+    struct node * first = NULL;
+    struct node * last  = NULL;
+    struct node * curr  = ll->head;
+    while(curr != NULL){
+        struct node * next = curr->next;
+        if(predicate(curr->data, ctx)){
+            if(prev == NULL){
+                ll->head = next;
+            }
+            else{
+                prev->next = next;
+            }
+            if(last == NULL){
+                first = curr;
+            }
+            else{
+                last->next = curr;
+            }
+            last = curr;
+            removed++;
+        }
+        else{
+            prev = curr;
+        }
+        curr = next;
+    }
+
+    if(removed > 0){
+        //the last kept node is the new tail
+        ll->tail = prev;
+        ll->finger_node = NULL;
+        ll->size -= removed;
+        node_free_chain(ll, first, last, removed);
+    }
+
+    return removed;
+}
+
+// Sorts the linked_list in ascending order.
+// \param ll : Pointer to linked_list.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_sort(struct linked_list * ll){
+
+    //check if input is NULL
+    if(ll == NULL){
+        return false;
+    }
+    if(ll->size < 2){
+        return true;
+    }
+
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        indexed_sort(ll);
+    }
+    else{
+        node_merge_sort(ll);
+        ll->finger_node = NULL;
+    }
+    return true;
+}
+
+// Sorts the linked_list in ascending order with a radix sort.
+// \param ll : Pointer to linked_list.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_radix_sort(struct linked_list * ll){
+
+    //check if input is NULL and the allocator isn't usable
+    if(ll == NULL || !allocator_can_alloc(&ll->allocator) || !allocator_can_free(&ll->allocator)){
+        return false;
+    }
+    if(ll->size < 2){
+        return true;
+    }
+
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        return indexed_radix_sort(ll);
+    }
+    node_radix_sort(ll);
+    ll->finger_node = NULL;
+    return true;
+}
+
+// Moves every element of src onto the end of dst, leaving src empty.
+// \param dst : Pointer to linked_list to append to.
+// \param src : Pointer to linked_list to take the elements from.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_splice(struct linked_list * dst,
+                        struct linked_list * src){
+
+    //check if input is NULL, the same list, or storage that can't be shared
+    if(dst == NULL || src == NULL || dst == src || dst->storage != src->storage ||
+       !allocator_equal(&dst->allocator, &src->allocator)){
+        return false;
+    }
+    if(src->size == 0){
+        return true;
+    }
+
+    if(dst->storage == LINKED_LIST_STORAGE_INDEXED){
+        //append the chunk pointers, src keeps its empty directory
+        if(!chunk_directory_reserve(dst, dst->chunk_count + src->chunk_count)){
+            return false;
+        }
+        for(size_t slot = 0; slot < src->chunk_count; slot++){
+            dst->chunks[dst->chunk_count++] = src->chunks[slot];
+            chunk_index_append(dst);
+        }
+        src->chunk_count = 0;
+    }
+    else{
+        //link the src nodes in after the dst tail, the dst finger stays valid
+        if(dst->head == NULL){
+            dst->head = src->head;
+        }
+        else{
+            dst->tail->next = src->head;
+        }
+        dst->tail = src->tail;
+        src->head = NULL;
+        src->tail = NULL;
+        src->finger_node = NULL;
+    }
+
+    dst->size += src->size;
+    src->size  = 0;
+
+    return true;
+}
+
 // Creates an iterator struct at a particular index.
 // \param linked_list : Pointer to linked_list.
 // \param index       : Index of the linked list to start at.
@@ -367,27 +1687,26 @@ bool linked_list_remove(struct linked_list * ll,
 struct iterator * linked_list_create_iterator(struct linked_list * ll,
                                               size_t index){
 
-    //check if input is NULL and malloc_fptr/free_fptr are NULL
-    if(ll == NULL || malloc_fptr == NULL || free_fptr == NULL || index >= ll->size){
+    //check if input is NULL and the allocator isn't usable
+    if(ll == NULL || !allocator_can_alloc(&ll->allocator) || !allocator_can_free(&ll->allocator) || index >= ll->size){
         return NULL;
     }
 
     //allocate iterator
-    struct iterator* iterator = malloc_fptr(sizeof(struct iterator));
+    struct iterator* iterator = ll->allocator.alloc(ll->allocator.state, sizeof(struct iterator));
     //exit if allocation wasn't successful
     if(iterator == NULL){
         return NULL;
     }
 
-    //counter for index tracker
-    size_t curr_idx = 0;
+    iterator->allocator = ll->allocator;
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        indexed_position(ll, index, iterator);
+        return iterator;
+    }
 
     //traverse to node to set the iterator
-    struct node* curr = ll->head;
-    while(curr != NULL && curr_idx < index){
-        curr = curr->next;
-        curr_idx++;
-    }
+    struct node* curr = node_at(ll, index);
 
     //set the iterator fields
     iterator->ll = ll;
@@ -405,13 +1724,14 @@ struct iterator * linked_list_create_iterator(struct linked_list * ll,
 //
 bool linked_list_delete_iterator(struct iterator * iter){
 
-    //check if input iter is NULL and free_fptr is is NULL
-    if(iter == NULL || free_fptr == NULL){
+    //check if input iter is NULL and its allocator can't free
+    if(iter == NULL || !allocator_can_free(&iter->allocator)){
         return false;
     }
 
     //free the input iterator
-    free_fptr(iter);
+    struct allocator allocator = iter->allocator;
+    allocator.free(allocator.state, iter);
 
     return true;
 }
@@ -422,6 +1742,25 @@ bool linked_list_delete_iterator(struct iterator * iter){
 //
 bool linked_list_iterate(struct iterator * iter){
 
+    //indexed lists step through the current chunk, then the next one
+    if(iter != NULL && iter->ll != NULL && iter->ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        struct linked_list * ll = iter->ll;
+        size_t slot   = iter->chunk_slot;
+        size_t offset = iter->chunk_offset + 1;
+        if(offset == ll->chunks[slot]->count){
+            if(slot + 1 >= ll->chunk_count){
+                return false;
+            }
+            slot++;
+            offset = 0;
+        }
+        iter->chunk_slot   = slot;
+        iter->chunk_offset = offset;
+        iter->current_index++;
+        iter->data = ll->chunks[slot]->data[offset];
+        return true;
+    }
+
     //check if input iterator, iter->current_node and iter->current_node->next are NULL
     if(iter == NULL || iter->current_node == NULL || iter->current_node->next == NULL){
         return false;
@@ -435,6 +1774,62 @@ bool linked_list_iterate(struct iterator * iter){
     return true;
 }
 
+// Starts a span iterator at the front of the linked_list.
+// \param ll   : Pointer to linked_list.
+// \param iter : Pointer to span iterator (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_span_begin(struct linked_list * ll,
+                            struct span_iterator * iter){
+
+    //check if input is NULL
+    if(ll == NULL || iter == NULL){
+        return false;
+    }
+
+    iter->ll           = ll;
+    iter->current_node = ll->head;
+    iter->chunk_slot   = 0;
+    return true;
+}
+
+// Returns the next run of contiguous elements and moves past it.
+// \param iter   : Span iterator to advance.
+// \param data   : Pointer to the first element of the run (provided by caller).
+// \param length : Pointer to the number of elements in the run (provided by caller).
+// Returns TRUE when a run is returned, FALSE once end of list is reached.
+//
+bool linked_list_next_span(struct span_iterator * iter,
+                           const unsigned int ** data,
+                           size_t * length){
+
+    //check if input is NULL
+    if(iter == NULL || iter->ll == NULL || data == NULL || length == NULL){
+        return false;
+    }
+
+    //a chunk is one run
+    struct linked_list * ll = iter->ll;
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        if(iter->chunk_slot >= ll->chunk_count){
+            return false;
+        }
+        struct linked_list_chunk * chunk = ll->chunks[iter->chunk_slot++];
+        *data   = chunk->data;
+        *length = chunk->count;
+        return true;
+    }
+
+    //a node is a run of one
+    if(iter->current_node == NULL){
+        return false;
+    }
+    *data   = &iter->current_node->data;
+    *length = 1;
+    iter->current_node = iter->current_node->next;
+    return true;
+}
+
 // Registers malloc() function.
 // \param malloc : Function pointer to malloc()-like function.
 // Returns TRUE on success, FALSE otherwise.
@@ -466,6 +1861,29 @@ bool linked_list_register_free(void (*free)(void*)){
     return true;
 }
 
+// Releases every slab held by the node pool.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_pool_destroy(void){
+
+    //refuse while nodes are still in use, their memory lives in the slabs
+    if(free_fptr == NULL || node_pool.live_nodes != 0){
+        return false;
+    }
+
+    struct node_slab * slab = node_pool.slabs;
+    while(slab != NULL){
+        struct node_slab * next = slab->next;
+        free_fptr(slab);
+        slab = next;
+    }
+
+    node_pool.slabs          = NULL;
+    node_pool.free_list      = NULL;
+    node_pool.slab_remaining = 0;
+
+    return true;
+}
 
 // Populates iterators that are locally allocated
 // on stack. Avoid malloc/free calls per iterator creation.
@@ -480,16 +1898,13 @@ bool __linked_list_populate_iterator(struct linked_list* ll,
     if(iterator == NULL || ll == NULL || index >= ll->size){
         return false;
     }
-
-    //counter for index tracker
-    size_t curr_idx = 0;
+    if(ll->storage == LINKED_LIST_STORAGE_INDEXED){
+        indexed_position(ll, index, iterator);
+        return true;
+    }
 
     //traverse to node to set the iterator
-    struct node* curr = ll->head;
-    while(curr != NULL && curr_idx < index){
-        curr = curr->next;
-        curr_idx++;
-    }
+    struct node* curr = node_at(ll, index);
 
     //set the iterator fields
     iterator->ll = ll;
@@ -28,6 +28,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "allocator.h"
+
 // Some rules for Pointer Wars 2025:
 // 0. Implement all functions in linked_list.c
 // 1. Feel free to add members to the structures, but please do not remove 
@@ -39,14 +41,62 @@
 //    test infrastructure a bit more flexility. See linked_list.c for
 //    declarations of those function pointers.
 
+// Number of elements held by one chunk of an indexed linked_list.
+//
+#define LINKED_LIST_CHUNK_CAPACITY 256
+
+// A run of consecutive elements of an indexed linked_list.
+//
+struct linked_list_chunk {
+    size_t count;
+    unsigned int data[LINKED_LIST_CHUNK_CAPACITY];
+};
+
+// Storage used by a linked_list. Picked at creation time and fixed for
+// the lifetime of the list.
+//
+enum linked_list_storage {
+    // One struct node per element. Used by linked_list_create().
+    LINKED_LIST_STORAGE_NODES,
+    // Elements packed into LINKED_LIST_CHUNK_CAPACITY sized chunks, with
+    // an index over the chunk counts so positional operations don't
+    // walk the list. Used by linked_list_create_indexed().
+    LINKED_LIST_STORAGE_INDEXED
+};
+
 // Declaration of the linked_list data structure.
 // Feel free to change as desired.
 //
+// Indexed storage keeps the chunks in order in the chunks[] directory
+// and a Fenwick tree over their counts in chunk_index[1 .. chunk_count],
+// so the chunk holding a given index is found in O(log n) and a count
+// change is recorded in O(log n). Splitting a full chunk or dropping
+// an empty one shifts the directory and rebuilds the tree, O(n / C)
+// for C = LINKED_LIST_CHUNK_CAPACITY, but happens at most once every
+// C / 2 edits. head and tail are unused (NULL) in this mode.
+//
 struct node;
 struct linked_list {
     struct node * head;
     struct node * tail;
     size_t size;
+    // Allocator context the list and its nodes come from. Lists using
+    // the default context draw nodes from the shared node pool, lists
+    // with their own context allocate and free nodes through it.
+    struct allocator allocator;
+    // Last node reached by index, and its index. Index operations at or
+    // after finger_index walk on from here instead of from head, so
+    // inserting or removing at k, k+1, k+2, ... costs O(1) a step. NULL
+    // when there is no valid finger, which any change ahead of it
+    // causes. Unused by indexed lists.
+    struct node * finger_node;
+    size_t finger_index;
+
+    enum linked_list_storage storage;
+    struct linked_list_chunk ** chunks;
+    size_t * chunk_index;
+    size_t chunk_count;
+    size_t chunk_slots;
 };
 
 // A node in the linked_list structure.
@@ -64,6 +114,25 @@ struct iterator {
     struct node * current_node;
     size_t current_index;
     unsigned int data;
+    // Position of the iterator in an indexed linked_list.
+    size_t chunk_slot;
+    size_t chunk_offset;
+    // Allocator context the iterator was allocated from. Kept here so
+    // the iterator can be deleted after its linked_list.
+    struct allocator allocator;
+};
+
+// Iterator over runs of contiguous elements rather than single
+// elements. Each step hands out a pointer and a length, so a consumer
+// can process a whole run with its own vector loop: a run is a full
+// chunk of an indexed linked_list and a single node otherwise. Meant
+// to live on the stack, it needs no allocation. Not thread safe, and
+// invalidated by any change to the linked_list.
+//
+struct span_iterator {
+    struct linked_list * ll;
+    struct node * current_node;
+    size_t chunk_slot;
 };
 
 // Creates a new linked_list.
@@ -75,6 +144,27 @@ struct iterator {
 //
 struct linked_list * linked_list_create(void);
 
+// Creates a new linked_list that allocates through its own allocator
+// context instead of the registered malloc() and free() functions.
+// Nodes are allocated from the context one at a time rather than from
+// the shared node pool, so lists with different contexts may be used
+// from different threads at the same time.
+// \param allocator : Allocator context, copied into the linked_list.
+// Returns a new linked_list on success, NULL on failure.
+//
+struct linked_list * linked_list_create_with_allocator(const struct allocator * allocator);
+
+// Creates a new linked_list with indexed storage. It supports the same
+// operations as any other linked_list, but linked_list_insert(),
+// linked_list_remove() and iterator creation take O(log n) to find
+// their position instead of walking from the head.
+// PRECONDITION: Register malloc() and free() functions via the
+//               linked_list_register_malloc() and
+//               linked_list_register_free() functions.
+// Returns a new linked_list on success, NULL on failure.
+//
+struct linked_list * linked_list_create_indexed(void);
+
 // Deletes a linked_list and frees all memory assoicated with it.
 // \param ll : Pointer to linked_list to delete
 // Returns TRUE on success, FALSE otherwise.
@@ -95,6 +185,17 @@ size_t linked_list_size(struct linked_list * ll);
 bool linked_list_insert_end(struct linked_list * ll,
                             unsigned int data);
 
+// Inserts n elements at the end of the linked_list, in order, as if
+// linked_list_insert_end() were called for each of them.
+// \param ll   : Pointer to linked_list.
+// \param data : Array of data to insert.
+// \param n    : Number of elements in data.
+// Returns TRUE on success, FALSE otherwise. On failure nothing is inserted.
+//
+bool linked_list_insert_end_bulk(struct linked_list * ll,
+                                 const unsigned int * data,
+                                 size_t n);
+
 // Inserts an element at the front of the linked_list.
 // \param ll   : Pointer to linked_list.
 // \param data : Data to insert.
@@ -121,6 +222,15 @@ bool linked_list_insert(struct linked_list * ll,
 size_t linked_list_find(struct linked_list * ll,
                         unsigned int data);
 
+// Counts the occurrences of data. Indexed lists are scanned a chunk at
+// a time with SIMD compares where the CPU supports them.
+// \param ll   : Pointer to linked_list.
+// \param data : Data to count.
+// Returns the number of matches on success, SIZE_MAX on failure.
+//
+size_t linked_list_count(struct linked_list * ll,
+                         unsigned int data);
+
 // Removes a node from the linked_list at a specific index.
 // \param ll    : Pointer to linked_list.
 // \param index : Index to remove node.
@@ -129,6 +239,65 @@ size_t linked_list_find(struct linked_list * ll,
 bool linked_list_remove(struct linked_list * ll,
                         size_t index);
 
+// Removes up to max elements from the front of the linked_list in one
+// pass, copying their data into out in list order. The removed nodes
+// are returned to the node pool together rather than one at a time.
+// \param ll      : Pointer to linked_list.
+// \param out     : Buffer (provided by caller) with room for max elements.
+// \param max     : Maximum number of elements to remove.
+// \param removed : Pointer to the number of elements removed (provided by
+//                  caller). Set to 0 on failure.
+// Returns TRUE if at least one element was removed, FALSE otherwise.
+//
+bool linked_list_remove_front_bulk(struct linked_list * ll,
+                                   unsigned int * out,
+                                   size_t max,
+                                   size_t * removed);
+
+// Removes every element for which predicate returns TRUE, in a single
+// pass over the linked_list. The predicate sees the elements in list
+// order. Removed nodes go back to the node pool as one chain, and an
+// indexed linked_list is compacted into as few chunks as it needs.
+// \param ll        : Pointer to linked_list.
+// \param predicate : Function called with each element and ctx.
+// \param ctx       : Opaque pointer handed to predicate.
+// Returns the number of elements removed on success, SIZE_MAX on failure.
+//
+size_t linked_list_remove_if(struct linked_list * ll,
+                             bool (*predicate)(unsigned int data, void * ctx),
+                             void * ctx);
+
+// Sorts the linked_list in ascending order, in place. Node lists are
+// merge sorted bottom-up by relinking nodes, which is stable and needs
+// no memory beyond a fixed table of pending runs. Indexed lists are
+// heapsorted inside their chunks. O(n log n) either way.
+// \param ll : Pointer to linked_list.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_sort(struct linked_list * ll);
+
+// Sorts the linked_list in ascending order with an LSD radix sort on
+// the unsigned int keys, skipping passes over digits that all elements
+// share. Node lists relink their nodes into 2048 buckets per pass and
+// need no memory beyond the bucket table. Indexed lists use 8-bit
+// digits and a scratch array of one unsigned int per element.
+// \param ll : Pointer to linked_list.
+// Returns TRUE on success, FALSE otherwise. The list is unchanged on failure.
+//
+bool linked_list_radix_sort(struct linked_list * ll);
+
+// Moves every element of src onto the end of dst, in order, leaving src
+// empty. Nothing is copied: node lists relink their nodes in O(1), and
+// indexed lists hand their chunks over in O(chunks of src).
+// PRECONDITION: dst and src use the same storage and the same
+//               allocator context.
+// \param dst : Pointer to linked_list to append to.
+// \param src : Pointer to linked_list to take the elements from.
+// Returns TRUE on success, FALSE otherwise. Both lists are unchanged on failure.
+//
+bool linked_list_splice(struct linked_list * dst,
+                        struct linked_list * src);
+
 // Creates an iterator struct at a particular index.
 // \param linked_list : Pointer to linked_list.
 // \param index       : Index of the linked list to start at.
@@ -149,6 +318,26 @@ bool linked_list_delete_iterator(struct iterator * iter);
 //
 bool linked_list_iterate(struct iterator * iter);
 
+// Starts a span iterator at the front of the linked_list.
+// \param ll   : Pointer to linked_list.
+// \param iter : Pointer to span iterator (provided by caller).
+// Returns TRUE on success, FALSE otherwise.
+//
+bool linked_list_span_begin(struct linked_list * ll,
+                            struct span_iterator * iter);
+
+// Returns the next run of contiguous elements and moves past it. The
+// elements are data[0 .. length), in list order, and stay valid until
+// the linked_list is changed.
+// \param iter   : Span iterator to advance.
+// \param data   : Pointer to the first element of the run (provided by caller).
+// \param length : Pointer to the number of elements in the run (provided by caller).
+// Returns TRUE when a run is returned, FALSE once end of list is reached.
+//
+bool linked_list_next_span(struct span_iterator * iter,
+                           const unsigned int ** data,
+                           size_t * length);
+
 // Registers malloc() function.
 // \param malloc : Function pointer to malloc()-like function.
 // Returns TRUE on success, FALSE otherwise.
@@ -161,6 +350,16 @@ bool linked_list_register_malloc(void * (*malloc)(size_t));
 //
 bool linked_list_register_free(void (*free)(void*));
 
+// Nodes are not allocated one malloc() at a time. They are carved out
+// of large slabs, and nodes freed by linked_list_remove() and
+// linked_list_delete() are kept on a free list shared by every
+// linked_list in the process, so later inserts reuse them without
+// calling malloc(). The slabs are held until this function is called.
+// PRECONDITION: Every linked_list has been deleted or emptied.
+// Returns TRUE on success, FALSE if nodes are still in use.
+//
+bool linked_list_pool_destroy(void);
+
 
 // Populates iterators that are locally allocated
 // on stack. Avoid malloc/free calls per iterator creation.
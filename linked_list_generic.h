@@ -0,0 +1,162 @@
+#ifndef _LINKED_LIST_GENERIC_H
+#define _LINKED_LIST_GENERIC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "allocator.h"
+
+// Compile time generated, typed singly linked lists.
+//
+// DEFINE_LINKED_LIST(name, T) expands to a list of T whose elements are
+// stored by value inside the nodes, so a struct, a pair or a 64-bit id
+// can be kept in a list without boxing it behind a pointer. Everything
+// is static inline and can be inlined into the caller.
+//
+// It defines:
+//
+//   struct name_node { struct name_node * next; T data; };
+//   struct name      { head, tail, size, allocator };
+//
+//   struct name * name_create(const struct allocator * allocator);
+//   bool          name_delete(struct name * ll);
+//   size_t        name_size(const struct name * ll);
+//   bool          name_insert_end(struct name * ll, T data);
+//   bool          name_insert_front(struct name * ll, T data);
+//   bool          name_remove_front(struct name * ll, T * out);
+//   T *           name_front(struct name * ll);
+//   T *           name_back(struct name * ll);
+//
+// The list and its nodes come from the allocator context passed to
+// name_create(), see allocator.h. Functions return FALSE (or NULL,
+// SIZE_MAX) on NULL input, an empty list or allocation failure, like
+// their linked_list counterparts; out may be NULL to discard the
+// element. name_front() and name_back() return a pointer into the
+// node, valid until that element is removed.
+//
+// Use it at file scope, once per element type:
+//
+//   DEFINE_LINKED_LIST(u64_list, uint64_t)
+//
+#define DEFINE_LINKED_LIST(name, T)                                             \
+                                                                                \
+struct name##_node {                                                            \
+    struct name##_node * next;                                                  \
+    T data;                                                                     \
+};                                                                              \
+                                                                                \
+struct name {                                                                   \
+    struct name##_node * head;                                                  \
+    struct name##_node * tail;                                                  \
+    size_t size;                                                                \
+    struct allocator allocator;                                                 \
+};                                                                              \
+                                                                                \
+static inline struct name * name##_create(const struct allocator * allocator){  \
+    if(allocator == NULL || allocator->alloc == NULL || allocator->free == NULL){ \
+        return NULL;                                                            \
+    }                                                                           \
+    struct name * ll = (struct name *)allocator->alloc(allocator->state,        \
+                                                       sizeof(struct name));    \
+    if(ll == NULL){                                                             \
+        return NULL;                                                            \
+    }                                                                           \
+    ll->head      = NULL;                                                       \
+    ll->tail      = NULL;                                                       \
+    ll->size      = 0;                                                          \
+    ll->allocator = *allocator;                                                 \
+    return ll;                                                                  \
+}                                                                               \
+                                                                                \
+static inline bool name##_delete(struct name * ll){                             \
+    if(ll == NULL){                                                             \
+        return false;                                                           \
+    }                                                                           \
+    struct allocator allocator = ll->allocator;                                 \
+    struct name##_node * curr = ll->head;                                       \
+    while(curr != NULL){                                                        \
+        struct name##_node * next = curr->next;                                 \
+        allocator.free(allocator.state, curr);                                  \
+        curr = next;                                                            \
+    }                                                                           \
+    allocator.free(allocator.state, ll);                                        \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline size_t name##_size(const struct name * ll){                       \
+    return ll == NULL ? SIZE_MAX : ll->size;                                    \
+}                                                                               \
+                                                                                \
+static inline struct name##_node * name##_node_alloc(struct name * ll, T data){ \
+    struct name##_node * node = (struct name##_node *)ll->allocator.alloc(      \
+        ll->allocator.state, sizeof(struct name##_node));                       \
+    if(node != NULL){                                                           \
+        node->next = NULL;                                                      \
+        node->data = data;                                                      \
+    }                                                                           \
+    return node;                                                                \
+}                                                                               \
+                                                                                \
+static inline bool name##_insert_end(struct name * ll, T data){                 \
+    if(ll == NULL){                                                             \
+        return false;                                                           \
+    }                                                                           \
+    struct name##_node * node = name##_node_alloc(ll, data);                    \
+    if(node == NULL){                                                           \
+        return false;                                                           \
+    }                                                                           \
+    if(ll->tail == NULL){                                                       \
+        ll->head = node;                                                        \
+    }                                                                           \
+    else{                                                                       \
+        ll->tail->next = node;                                                  \
+    }                                                                           \
+    ll->tail = node;                                                            \
+    ll->size++;                                                                 \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline bool name##_insert_front(struct name * ll, T data){               \
+    if(ll == NULL){                                                             \
+        return false;                                                           \
+    }                                                                           \
+    struct name##_node * node = name##_node_alloc(ll, data);                    \
+    if(node == NULL){                                                           \
+        return false;                                                           \
+    }                                                                           \
+    node->next = ll->head;                                                      \
+    ll->head   = node;                                                          \
+    if(ll->tail == NULL){                                                       \
+        ll->tail = node;                                                        \
+    }                                                                           \
+    ll->size++;                                                                 \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline bool name##_remove_front(struct name * ll, T * out){              \
+    if(ll == NULL || ll->head == NULL){                                         \
+        return false;                                                           \
+    }                                                                           \
+    struct name##_node * node = ll->head;                                       \
+    if(out != NULL){                                                            \
+        *out = node->data;                                                      \
+    }                                                                           \
+    ll->head = node->next;                                                      \
+    if(ll->head == NULL){                                                       \
+        ll->tail = NULL;                                                        \
+    }                                                                           \
+    ll->size--;                                                                 \
+    ll->allocator.free(ll->allocator.state, node);                              \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline T * name##_front(struct name * ll){                               \
+    return (ll == NULL || ll->head == NULL) ? NULL : &ll->head->data;           \
+}                                                                               \
+                                                                                \
+static inline T * name##_back(struct name * ll){                                \
+    return (ll == NULL || ll->tail == NULL) ? NULL : &ll->tail->data;           \
+}
+
+#endif
@@ -1,12 +1,25 @@
+#include <fcntl.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "linked_list.h"
+#include "arena_list.h"
 #include "queue.h"
+#include "queue_inline.h"
+#include "linked_list_generic.h"
+#include "queue_generic.h"
+#include "deque.h"
+#include "spsc_queue.h"
+#include "mpmc_queue.h"
+#include "graph.h"
+#include "mmio.h"
 
 // Check that valid compiler defines have been passed in.
 //
@@ -18,6 +31,10 @@
 #define VALID_TEST
 #endif
 
+#ifdef TEST_GRAPH
+#define VALID_TEST
+#endif
+
 #ifndef VALID_TEST
 #error "Improper set of compiler defines specified, check Makefile"
 #endif
@@ -34,6 +51,7 @@
 
 bool instrumented_malloc_fail_next             = false;
 bool instrumented_malloc_last_alloc_successful = false;
+size_t instrumented_malloc_invocations         = 0;
 
 void gracefully_exit_on_suspected_infinite_loop(int signal_number) {
     // Use write() to tell the tester that they're probably stuck
@@ -69,6 +87,7 @@ void * instrumented_malloc(size_t size) {
 
     void * ptr = malloc(size);
     instrumented_malloc_last_alloc_successful = (ptr != NULL);
+    ++instrumented_malloc_invocations;
 
     return ptr;
 }
@@ -558,6 +577,2482 @@ void check_linked_list_additional_delete_tests(void) {
 #endif 
 }
 
+void check_linked_list_node_pool(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_node_pool)
+
+    // Fill a list, delete it, and check that a second list of the
+    // same size is built entirely from recycled nodes.
+    //
+    SUBTEST(nodes_recycled_across_lists)
+    struct linked_list * ll = linked_list_create();
+    FAIL(ll == NULL,
+         "Failed to create linked_list")
+    for (size_t i = 0; i < 10000; i++) {
+        FAIL(linked_list_insert_end(ll, i) == false,
+             "linked_list_insert_end() failed")
+    }
+    FAIL(linked_list_delete(ll) == false,
+         "Failed to delete linked_list")
+
+    ll = linked_list_create();
+    FAIL(ll == NULL,
+         "Failed to create linked_list")
+    size_t malloc_calls = instrumented_malloc_invocations;
+    for (size_t i = 0; i < 10000; i++) {
+        FAIL(linked_list_insert_front(ll, i) == false,
+             "linked_list_insert_front() failed")
+    }
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "Inserting into a new list did not reuse pooled nodes")
+
+    SUBTEST(pool_destroy_with_live_nodes)
+    FAIL(linked_list_pool_destroy() != false,
+         "linked_list_pool_destroy() succeeded while nodes were in use")
+
+    // Remove a few nodes one at a time to exercise the single node
+    // free path, then delete the rest.
+    //
+    SUBTEST(pool_destroy)
+    for (size_t i = 0; i < 100; i++) {
+        FAIL(linked_list_remove(ll, 0) == false,
+             "linked_list_remove() failed")
+    }
+    FAIL(linked_list_delete(ll) == false,
+         "Failed to delete linked_list")
+    FAIL(linked_list_pool_destroy() == false,
+         "linked_list_pool_destroy() failed with no nodes in use")
+
+    SUBTEST(insert_after_pool_destroy)
+    ll = linked_list_create();
+    FAIL(linked_list_insert_end(ll, 7) == false,
+         "linked_list_insert_end() failed after pool was destroyed")
+    FAIL(ll->head == NULL,
+         "linked_list head is NULL after insertion")
+    linked_list_delete(ll);
+
+    PASS(check_linked_list_node_pool)
+#endif
+}
+
+// Checks that ll holds exactly expected[0 .. count), walking it with
+// an iterator.
+//
+bool linked_list_matches(struct linked_list * ll, const unsigned int * expected, size_t count) {
+    if (linked_list_size(ll) != count) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+    struct iterator iter;
+    if (__linked_list_populate_iterator(ll, 0, &iter) == false) {
+        return false;
+    }
+    size_t i = 0;
+    do {
+        if (iter.current_index != i || iter.data != expected[i]) {
+            return false;
+        }
+        ++i;
+    } while (linked_list_iterate(&iter));
+    return i == count;
+}
+
+void check_linked_list_indexed(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_indexed)
+
+    static unsigned int expected[40000];
+    static unsigned int out[40000];
+    size_t count = 0;
+    unsigned int seed = 12345;
+
+    SUBTEST(indexed_empty)
+    struct linked_list * ll = linked_list_create_indexed();
+    FAIL(ll == NULL,
+         "linked_list_create_indexed() failed")
+    FAIL(linked_list_size(ll) != 0 || linked_list_find(ll, 0) != SIZE_MAX,
+         "Empty indexed linked_list is not empty")
+    FAIL(linked_list_remove(ll, 0) != false || linked_list_create_iterator(ll, 0) != NULL,
+         "Empty indexed linked_list accepted index 0")
+
+    // Random inserts and removes by position, against a plain array.
+    // Enough elements to split and merge plenty of chunks.
+    //
+    SUBTEST(indexed_random_edits)
+    for (size_t step = 0; step < 30000; step++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int r = seed >> 8;
+        if (count > 0 && r % 3 == 0) {
+            size_t index = r % count;
+            FAIL(linked_list_remove(ll, index) == false,
+                 "linked_list_remove() failed on indexed linked_list")
+            memmove(expected + index, expected + index + 1, (count - index - 1) * sizeof(unsigned int));
+            --count;
+        } else {
+            size_t index = r % (count + 1);
+            FAIL(linked_list_insert(ll, index, (unsigned int)step) == false,
+                 "linked_list_insert() failed on indexed linked_list")
+            memmove(expected + index + 1, expected + index, (count - index) * sizeof(unsigned int));
+            expected[index] = (unsigned int)step;
+            ++count;
+        }
+    }
+    FAIL(!linked_list_matches(ll, expected, count),
+         "Indexed linked_list contents wrong after random edits")
+
+    SUBTEST(indexed_iterator_positioning)
+    for (size_t i = 0; i < count; i += 97) {
+        struct iterator * iter = linked_list_create_iterator(ll, i);
+        FAIL(iter == NULL || iter->current_index != i || iter->data != expected[i],
+             "linked_list_create_iterator() positioned wrongly on indexed linked_list")
+        linked_list_delete_iterator(iter);
+    }
+    FAIL(linked_list_find(ll, expected[count / 2]) > count / 2,
+         "linked_list_find() failed on indexed linked_list")
+
+    SUBTEST(indexed_front_and_end)
+    for (unsigned int i = 0; i < 1000; i++) {
+        FAIL(linked_list_insert_front(ll, 100000 + i) == false ||
+             linked_list_insert_end(ll, 200000 + i) == false,
+             "Inserting at the ends of an indexed linked_list failed")
+        memmove(expected + 1, expected, count * sizeof(unsigned int));
+        expected[0] = 100000 + i;
+        expected[count + 1] = 200000 + i;
+        count += 2;
+    }
+    FAIL(!linked_list_matches(ll, expected, count),
+         "Indexed linked_list contents wrong after inserting at the ends")
+
+    SUBTEST(indexed_bulk)
+    unsigned int batch[3 * LINKED_LIST_CHUNK_CAPACITY + 5];
+    for (size_t i = 0; i < 3 * LINKED_LIST_CHUNK_CAPACITY + 5; i++) {
+        batch[i] = 300000 + i;
+    }
+    FAIL(linked_list_insert_end_bulk(ll, batch, 3 * LINKED_LIST_CHUNK_CAPACITY + 5) == false,
+         "linked_list_insert_end_bulk() failed on indexed linked_list")
+    memcpy(expected + count, batch, sizeof(batch));
+    count += 3 * LINKED_LIST_CHUNK_CAPACITY + 5;
+    size_t removed = 0;
+    FAIL(linked_list_remove_front_bulk(ll, out, 2 * LINKED_LIST_CHUNK_CAPACITY + 3, &removed) == false ||
+         removed != 2 * LINKED_LIST_CHUNK_CAPACITY + 3 ||
+         memcmp(out, expected, removed * sizeof(unsigned int)) != 0,
+         "linked_list_remove_front_bulk() returned wrong data from indexed linked_list")
+    memmove(expected, expected + removed, (count - removed) * sizeof(unsigned int));
+    count -= removed;
+    FAIL(!linked_list_matches(ll, expected, count),
+         "Indexed linked_list contents wrong after bulk operations")
+
+    SUBTEST(indexed_drain)
+    FAIL(linked_list_remove_front_bulk(ll, out, count, &removed) == false || removed != count ||
+         memcmp(out, expected, count * sizeof(unsigned int)) != 0,
+         "Draining indexed linked_list returned wrong data")
+    FAIL(linked_list_size(ll) != 0 || linked_list_insert(ll, 0, 5) == false ||
+         linked_list_find(ll, 5) != 0,
+         "Indexed linked_list unusable after being drained")
+    FAIL(linked_list_delete(ll) == false,
+         "Failed to delete indexed linked_list")
+
+    PASS(check_linked_list_indexed)
+#endif
+}
+
+void check_linked_list_finger(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_finger)
+
+    // Mirror a mix of index operations in an array. Runs of inserts and
+    // removals at k, k+1, ... move the finger forward; inserts and
+    // removals at the front, bulk removals and jumps backwards must
+    // drop or bypass it.
+    //
+    enum { capacity = 4096 };
+    unsigned int expected[capacity];
+    size_t count = 0;
+    unsigned int seed = 12345;
+
+    SUBTEST(finger_sequences)
+    struct linked_list * ll = linked_list_create();
+    FAIL(ll == NULL,
+         "Failed to create linked_list")
+    for (int round = 0; round < 200; round++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t k = count == 0 ? 0 : (seed >> 8) % (count + 1);
+        unsigned int op = (seed >> 4) % 6;
+        if (op <= 1) {
+            //a run of inserts at k, k+1, ...
+            for (unsigned int j = 0; j < 8 && count < capacity; j++, k++) {
+                FAIL(linked_list_insert(ll, k, seed + j) == false,
+                     "linked_list_insert() failed")
+                memmove(&expected[k + 1], &expected[k], (count - k) * sizeof(unsigned int));
+                expected[k] = seed + j;
+                count++;
+            }
+        }
+        else if (op == 2) {
+            //a run of removals at k, k+1, ...
+            for (unsigned int j = 0; j < 4 && k < count; j++, k++) {
+                FAIL(linked_list_remove(ll, k) == false,
+                     "linked_list_remove() failed")
+                memmove(&expected[k], &expected[k + 1], (count - k - 1) * sizeof(unsigned int));
+                count--;
+            }
+        }
+        else if (op == 3 && count < capacity) {
+            FAIL(linked_list_insert_front(ll, seed) == false,
+                 "linked_list_insert_front() failed")
+            memmove(&expected[1], &expected[0], count * sizeof(unsigned int));
+            expected[0] = seed;
+            count++;
+        }
+        else if (op == 4 && count > 0) {
+            FAIL(linked_list_remove(ll, 0) == false,
+                 "linked_list_remove() failed at index 0")
+            memmove(&expected[0], &expected[1], (count - 1) * sizeof(unsigned int));
+            count--;
+        }
+        else if (op == 5 && count > 0) {
+            unsigned int out[3];
+            size_t removed = 0;
+            FAIL(linked_list_remove_front_bulk(ll, out, 3, &removed) == false,
+                 "linked_list_remove_front_bulk() failed")
+            memmove(&expected[0], &expected[removed], (count - removed) * sizeof(unsigned int));
+            count -= removed;
+        }
+        FAIL(!linked_list_matches(ll, expected, count),
+             "linked_list doesn't match the expected contents")
+    }
+    linked_list_delete(ll);
+
+    // Index 1 in a longer list, which the walk to index - 1 used to
+    // overshoot.
+    //
+    SUBTEST(finger_index_one)
+    ll = linked_list_create();
+    FAIL(ll == NULL,
+         "Failed to create linked_list")
+    for (unsigned int i = 0; i < 4; i++) {
+        linked_list_insert_end(ll, i);
+    }
+    unsigned int inserted[] = { 0, 99, 1, 2, 3 };
+    FAIL(linked_list_insert(ll, 1, 99) == false || !linked_list_matches(ll, inserted, 5),
+         "linked_list_insert() at index 1 put the element in the wrong place")
+    unsigned int removed[] = { 0, 1, 2, 3 };
+    FAIL(linked_list_remove(ll, 1) == false || !linked_list_matches(ll, removed, 4),
+         "linked_list_remove() at index 1 removed the wrong element")
+    linked_list_delete(ll);
+
+    PASS(check_linked_list_finger)
+#endif
+}
+
+void check_linked_list_spans(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_spans)
+
+    SUBTEST(spans_null)
+    struct span_iterator iter;
+    const unsigned int * data = NULL;
+    size_t length = 0;
+    FAIL(linked_list_span_begin(NULL, &iter) == true,
+         "linked_list_span_begin() accepted a NULL linked_list")
+
+    // The runs, concatenated, must give back the list in order: one
+    // run per node, or one per chunk of an indexed list.
+    //
+    size_t count = 3 * LINKED_LIST_CHUNK_CAPACITY + 7;
+    for (int mode = 0; mode < 2; mode++) {
+        SUBTEST(spans_cover_list)
+        struct linked_list * ll = mode == 0 ? linked_list_create() : linked_list_create_indexed();
+        FAIL(ll == NULL,
+             "Failed to create linked_list")
+        FAIL(linked_list_span_begin(ll, &iter) == false,
+             "linked_list_span_begin() failed")
+        FAIL(linked_list_next_span(&iter, &data, &length) == true,
+             "Empty linked_list returned a span")
+        for (size_t i = 0; i < count; i++) {
+            FAIL(linked_list_insert_end(ll, (unsigned int)i * 3) == false,
+                 "linked_list_insert_end() failed")
+        }
+        //split a chunk in the middle so runs have uneven lengths
+        FAIL(linked_list_insert(ll, 10, 30) == false || linked_list_remove(ll, 10) == false,
+             "linked_list_insert() or linked_list_remove() failed")
+
+        size_t seen = 0;
+        size_t spans = 0;
+        FAIL(linked_list_span_begin(ll, &iter) == false,
+             "linked_list_span_begin() failed")
+        while (linked_list_next_span(&iter, &data, &length)) {
+            FAIL(length == 0,
+                 "linked_list_next_span() returned an empty span")
+            for (size_t i = 0; i < length; i++) {
+                FAIL(data[i] != (unsigned int)(seen + i) * 3,
+                     "Span element doesn't match the list")
+            }
+            seen += length;
+            spans++;
+        }
+        FAIL(seen != count,
+             "Spans don't cover the whole linked_list")
+        FAIL(mode == 0 && spans != count,
+             "Node linked_list returned spans longer than one")
+        FAIL(mode == 1 && spans != ll->chunk_count,
+             "Indexed linked_list didn't return one span per chunk")
+        linked_list_delete(ll);
+    }
+
+    PASS(check_linked_list_spans)
+#endif
+}
+
+void check_linked_list_find_and_count(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_find_and_count)
+
+    SUBTEST(count_null)
+    FAIL(linked_list_count(NULL, 0) != SIZE_MAX,
+         "linked_list_count(NULL, 0) did not return SIZE_MAX")
+
+    // Both storage modes, with the element count chosen so the last
+    // chunk is partly filled and the vector loops have a scalar tail.
+    //
+    size_t count = 5 * LINKED_LIST_CHUNK_CAPACITY + 13;
+    for (int mode = 0; mode < 2; mode++) {
+        SUBTEST(find_and_count)
+        struct linked_list * ll = mode == 0 ? linked_list_create() : linked_list_create_indexed();
+        FAIL(ll == NULL,
+             "Failed to create linked_list")
+        FAIL(linked_list_count(ll, 0) != 0 || linked_list_find(ll, 0) != SIZE_MAX,
+             "Empty linked_list matched a value")
+        for (size_t i = 0; i < count; i++) {
+            FAIL(linked_list_insert_end(ll, (unsigned int)(i % 1000)) == false,
+                 "linked_list_insert_end() failed")
+        }
+        for (unsigned int value = 0; value < 1000; value += 37) {
+            size_t expected = 0;
+            for (size_t i = 0; i < count; i++) {
+                expected += (i % 1000) == value;
+            }
+            FAIL(linked_list_find(ll, value) != value,
+                 "linked_list_find() returned the wrong index")
+            FAIL(linked_list_count(ll, value) != expected,
+                 "linked_list_count() returned the wrong count")
+        }
+
+        // Single matches at every position around a chunk boundary and
+        // at the very end.
+        //
+        size_t positions[] = { 15, 16, 17, LINKED_LIST_CHUNK_CAPACITY - 1,
+                               LINKED_LIST_CHUNK_CAPACITY, LINKED_LIST_CHUNK_CAPACITY + 1,
+                               count - 1 };
+        for (size_t p = 0; p < sizeof(positions) / sizeof(positions[0]); p++) {
+            unsigned int marker = 5000 + (unsigned int)p;
+            FAIL(linked_list_insert(ll, positions[p], marker) == false,
+                 "linked_list_insert() failed")
+            FAIL(linked_list_find(ll, marker) != positions[p] || linked_list_count(ll, marker) != 1,
+                 "linked_list_find() missed a single match")
+            FAIL(linked_list_remove(ll, positions[p]) == false,
+                 "linked_list_remove() failed")
+        }
+        FAIL(linked_list_find(ll, 1000) != SIZE_MAX || linked_list_count(ll, 1000) != 0,
+             "linked_list matched a value that isn't there")
+        linked_list_delete(ll);
+    }
+
+    PASS(check_linked_list_find_and_count)
+#endif
+}
+
+void check_arena_list(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_arena_list)
+
+    SUBTEST(arena_list_null)
+    FAIL(arena_list_delete(NULL) != false || arena_list_size(NULL) != SIZE_MAX,
+         "arena_list functions accepted a NULL list")
+    FAIL(arena_list_insert_end(NULL, 0) != false || arena_list_find(NULL, 0) != SIZE_MAX,
+         "arena_list functions accepted a NULL list")
+
+    SUBTEST(arena_node_size)
+    FAIL(sizeof(struct arena_node) != 8,
+         "struct arena_node is not 8 bytes")
+
+    // Same sequence of operations as on a linked_list, checked against
+    // a plain array.
+    //
+    SUBTEST(arena_list_operations)
+    struct arena_list * al = arena_list_create();
+    FAIL(al == NULL,
+         "arena_list_create() failed")
+    unsigned int expected[1000];
+    size_t count = 0;
+    for (unsigned int i = 0; i < 300; i++) {
+        FAIL(arena_list_insert_end(al, i) == false,
+             "arena_list_insert_end() failed")
+        expected[count++] = i;
+    }
+    for (unsigned int i = 0; i < 100; i++) {
+        FAIL(arena_list_insert_front(al, 1000 + i) == false,
+             "arena_list_insert_front() failed")
+        memmove(expected + 1, expected, count * sizeof(unsigned int));
+        expected[0] = 1000 + i;
+        count++;
+    }
+    for (size_t i = 0; i < 50; i++) {
+        size_t index = (i * 7) % count;
+        FAIL(arena_list_remove(al, index) == false,
+             "arena_list_remove() failed")
+        memmove(expected + index, expected + index + 1, (count - index - 1) * sizeof(unsigned int));
+        count--;
+    }
+    for (unsigned int i = 0; i < 50; i++) {
+        size_t index = (i * 13) % (count + 1);
+        FAIL(arena_list_insert(al, index, 2000 + i) == false,
+             "arena_list_insert() failed")
+        memmove(expected + index + 1, expected + index, (count - index) * sizeof(unsigned int));
+        expected[index] = 2000 + i;
+        count++;
+    }
+    FAIL(arena_list_insert(al, count + 1, 0) != false || arena_list_remove(al, count) != false,
+         "arena_list accepted an out of range index")
+    FAIL(arena_list_size(al) != count,
+         "arena_list_size() is wrong")
+    size_t expected_index = 0;
+    while (expected[expected_index] != 2049) {
+        expected_index++;
+    }
+    FAIL(arena_list_find(al, 2049) != expected_index,
+         "arena_list_find() returned the wrong index")
+    FAIL(arena_list_find(al, 5000) != SIZE_MAX,
+         "arena_list_find() found data that isn't there")
+    unsigned int data = 0;
+    for (size_t i = 0; i < count; i++) {
+        FAIL(arena_list_remove_front(al, &data) == false || data != expected[i],
+             "arena_list_remove_front() returned wrong data")
+    }
+    FAIL(arena_list_remove_front(al, &data) != false,
+         "arena_list_remove_front() on an empty list did not return false")
+    arena_list_delete(al);
+
+    // Used as a FIFO, a list sized up front never reallocates and
+    // costs 8 bytes per element.
+    //
+    SUBTEST(arena_list_with_capacity)
+    al = arena_list_create_with_capacity(100000);
+    FAIL(al == NULL,
+         "arena_list_create_with_capacity() failed")
+    FAIL(arena_list_memory(al) != 100000 * sizeof(struct arena_node),
+         "arena_list node array has the wrong size")
+    size_t malloc_calls = instrumented_malloc_invocations;
+    for (unsigned int round = 0; round < 3; round++) {
+        for (unsigned int i = 0; i < 100000; i++) {
+            FAIL(arena_list_insert_end(al, i) == false,
+                 "arena_list_insert_end() failed")
+        }
+        for (unsigned int i = 0; i < 100000; i++) {
+            FAIL(arena_list_remove_front(al, &data) == false || data != i,
+                 "arena_list_remove_front() returned wrong data")
+        }
+    }
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "arena_list allocated within its capacity")
+    arena_list_insert_end(al, 0);
+    arena_list_delete(al);
+
+    PASS(check_arena_list)
+#endif
+}
+
+void check_queue_chunk_boundaries(void) {
+#ifdef TEST_QUEUE
+    TEST(check_queue_chunk_boundaries)
+
+    // Push enough values to span several chunks, pop part of them,
+    // push some more, and make sure FIFO order survives every chunk
+    // transition.
+    //
+    SUBTEST(push_across_chunks)
+    struct queue * queue = queue_create();
+    FAIL(queue == NULL,
+         "Failed to create queue.")
+    const size_t first_batch = 2 * QUEUE_CHUNK_CAPACITY + 7;
+    for (size_t i = 0; i < first_batch; i++) {
+        bool status = queue_push(queue, i);
+        FAIL(status == false,
+             "queue_push() failed while filling multiple chunks")
+    }
+    FAIL(queue_size(queue) != first_batch,
+         "queue_size() incorrect after filling multiple chunks")
+
+    SUBTEST(pop_across_chunks)
+    unsigned int data     = 0;
+    unsigned int expected = 0;
+    for (size_t i = 0; i < QUEUE_CHUNK_CAPACITY + 3; i++) {
+        bool status = queue_pop(queue, &data);
+        FAIL(status == false || data != expected,
+             "queue_pop() returned wrong data across a chunk boundary")
+        ++expected;
+    }
+
+    SUBTEST(interleave_push_and_pop)
+    const size_t second_batch = QUEUE_CHUNK_CAPACITY + 11;
+    for (size_t i = first_batch; i < first_batch + second_batch; i++) {
+        bool status = queue_push(queue, i);
+        FAIL(status == false,
+             "queue_push() failed after partially draining queue")
+    }
+    while (queue_has_next(queue)) {
+        unsigned int next = 0;
+        bool status = queue_next(queue, &next);
+        FAIL(status == false || next != expected,
+             "queue_next() returned wrong data")
+        status = queue_pop(queue, &data);
+        FAIL(status == false || data != expected,
+             "queue_pop() returned wrong data after interleaving")
+        ++expected;
+    }
+    FAIL(expected != first_batch + second_batch,
+         "queue did not return every pushed value")
+    FAIL(queue_size(queue) != 0,
+         "queue_size() non-zero after draining")
+
+    SUBTEST(reuse_after_drain)
+    for (size_t i = 0; i < 3; i++) {
+        bool status = queue_push(queue, i);
+        FAIL(status == false,
+             "queue_push() failed on drained queue")
+    }
+    for (size_t i = 0; i < 3; i++) {
+        bool status = queue_pop(queue, &data);
+        FAIL(status == false || data != i,
+             "queue_pop() returned wrong data on reused queue")
+    }
+
+    bool status = queue_delete(queue);
+    FAIL(status == false,
+         "Failed to delete queue")
+
+    PASS(check_queue_chunk_boundaries)
+#endif
+}
+
+void check_queue_ring_buffer(void) {
+#ifdef TEST_QUEUE
+    TEST(check_queue_ring_buffer)
+
+    SUBTEST(queue_create_with_capacity)
+    struct queue * queue = queue_create_with_capacity(5);
+    FAIL(queue == NULL,
+         "Failed to create queue with a capacity hint.")
+    FAIL(queue_size(queue) != 0,
+         "queue_size() non-zero for new ring buffer queue")
+    FAIL(queue_has_next(queue) != false,
+         "queue_has_next() returned true for new ring buffer queue")
+
+    // Move the head part way into the buffer so that later pushes
+    // wrap around, then push past the capacity to force a grow while
+    // wrapped.
+    //
+    SUBTEST(wrap_around)
+    unsigned int data     = 0;
+    unsigned int expected = 0;
+    unsigned int next     = 0;
+    for (unsigned int i = 0; i < 10; i++) {
+        FAIL(queue_push(queue, next++) == false,
+             "queue_push() failed on ring buffer queue")
+    }
+    for (unsigned int i = 0; i < 7; i++) {
+        bool status = queue_pop(queue, &data);
+        FAIL(status == false || data != expected,
+             "queue_pop() returned wrong data from ring buffer queue")
+        ++expected;
+    }
+
+    SUBTEST(grow_while_wrapped)
+    for (unsigned int i = 0; i < 4 * QUEUE_RING_MIN_CAPACITY; i++) {
+        FAIL(queue_push(queue, next++) == false,
+             "queue_push() failed to grow ring buffer queue")
+    }
+    FAIL(queue_size(queue) != next - expected,
+         "queue_size() incorrect after growing ring buffer queue")
+
+    SUBTEST(drain)
+    while (queue_has_next(queue)) {
+        unsigned int peek = 0;
+        bool status = queue_next(queue, &peek);
+        FAIL(status == false || peek != expected,
+             "queue_next() returned wrong data from ring buffer queue")
+        status = queue_pop(queue, &data);
+        FAIL(status == false || data != expected,
+             "queue_pop() returned wrong data after ring buffer growth")
+        ++expected;
+    }
+    FAIL(expected != next,
+         "ring buffer queue did not return every pushed value")
+    FAIL(queue_pop(queue, &data) != false,
+         "queue_pop() returned true on drained ring buffer queue")
+
+    bool status = queue_delete(queue);
+    FAIL(status == false,
+         "Failed to delete ring buffer queue")
+
+    PASS(check_queue_ring_buffer)
+#endif
+}
+
+void check_bulk_insertion(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_insert_end_bulk)
+
+    unsigned int values[6000];
+    for (size_t i = 0; i < 6000; i++) {
+        values[i] = i;
+    }
+
+    SUBTEST(insert_end_bulk)
+    struct linked_list * ll = linked_list_create();
+    FAIL(linked_list_insert_end(ll, 6000) == false,
+         "linked_list_insert_end() failed")
+    FAIL(linked_list_insert_end_bulk(ll, values, 0) == false,
+         "linked_list_insert_end_bulk() failed for zero elements")
+    FAIL(linked_list_insert_end_bulk(ll, values, 100) == false,
+         "linked_list_insert_end_bulk() failed")
+    FAIL(linked_list_size(ll) != 101,
+         "linked_list size incorrect after bulk insertion")
+    struct iterator * iter = linked_list_create_iterator(ll, 0);
+    FAIL(iter->data != 6000,
+         "Bulk insertion modified existing head of linked_list")
+    for (size_t i = 0; i < 100; i++) {
+        linked_list_iterate(iter);
+        FAIL(iter->data != i,
+             "Bulk inserted data out of order")
+    }
+    linked_list_delete_iterator(iter);
+
+    // Start from an empty pool holding one live node, so that the
+    // batch exhausts the first slab and the allocation of the second
+    // one fails part way through.
+    //
+    SUBTEST(insert_end_bulk_allocation_failure)
+    linked_list_delete(ll);
+    linked_list_pool_destroy();
+    ll = linked_list_create();
+    FAIL(linked_list_insert_end(ll, 7) == false,
+         "linked_list_insert_end() failed")
+    instrumented_malloc_fail_next = true;
+    FAIL(linked_list_insert_end_bulk(ll, values, 6000) != false,
+         "linked_list_insert_end_bulk() succeeded when malloc() failed")
+    instrumented_malloc_fail_next = false;
+    FAIL(linked_list_size(ll) != 1 || ll->head != ll->tail || ll->tail->next != NULL,
+         "Failed linked_list_insert_end_bulk() modified the linked_list")
+
+    SUBTEST(insert_end_bulk_into_empty)
+    linked_list_remove(ll, 0);
+    FAIL(linked_list_insert_end_bulk(ll, values, 6000) == false,
+         "linked_list_insert_end_bulk() failed on empty linked_list")
+    FAIL(linked_list_find(ll, 5999) != 5999,
+         "Bulk inserted data not found at expected index")
+    FAIL(ll->tail->data != 5999,
+         "Tail not updated by linked_list_insert_end_bulk()")
+    linked_list_delete(ll);
+
+    PASS(check_linked_list_insert_end_bulk)
+#endif
+
+#ifdef TEST_QUEUE
+    TEST(check_queue_push_bulk)
+
+    static unsigned int batch[3 * QUEUE_CHUNK_CAPACITY];
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY; i++) {
+        batch[i] = i;
+    }
+
+    // Chunked queue: one value to start, then a batch spanning
+    // several chunks.
+    //
+    SUBTEST(push_bulk_chunked)
+    struct queue * queue = queue_create();
+    FAIL(queue_push(queue, 0) == false,
+         "queue_push() failed")
+    FAIL(queue_push_bulk(queue, batch + 1, 3 * QUEUE_CHUNK_CAPACITY - 1) == false,
+         "queue_push_bulk() failed on chunked queue")
+    FAIL(queue_size(queue) != 3 * QUEUE_CHUNK_CAPACITY,
+         "queue_size() incorrect after queue_push_bulk()")
+    unsigned int data = 0;
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY; i++) {
+        bool status = queue_pop(queue, &data);
+        FAIL(status == false || data != i,
+             "queue_pop() returned wrong data after queue_push_bulk()")
+    }
+
+    // Leave a drained chunk in the queue as its spare so the first
+    // chunk of the next batch comes for free and the second one fails.
+    //
+    SUBTEST(push_bulk_allocation_failure)
+    FAIL(queue_push_bulk(queue, batch, QUEUE_CHUNK_CAPACITY + 1) == false,
+         "queue_push_bulk() failed")
+    for (size_t i = 0; i < QUEUE_CHUNK_CAPACITY; i++) {
+        queue_pop(queue, &data);
+    }
+    instrumented_malloc_fail_next = true;
+    FAIL(queue_push_bulk(queue, batch, 3 * QUEUE_CHUNK_CAPACITY) != false,
+         "queue_push_bulk() succeeded when malloc() failed")
+    instrumented_malloc_fail_next = false;
+    FAIL(queue_size(queue) != 1,
+         "Failed queue_push_bulk() modified the queue size")
+    FAIL(queue_push_bulk(queue, batch, 5) == false,
+         "queue_push_bulk() failed after an earlier failure")
+    FAIL(queue_pop(queue, &data) == false || data != QUEUE_CHUNK_CAPACITY,
+         "Failed queue_push_bulk() modified the queue contents")
+    for (size_t i = 0; i < 5; i++) {
+        bool status = queue_pop(queue, &data);
+        FAIL(status == false || data != i,
+             "queue_pop() returned wrong data after failed queue_push_bulk()")
+    }
+    queue_delete(queue);
+
+    // Ring buffer queue: wrap the head around, then push a batch that
+    // both wraps and forces a grow.
+    //
+    SUBTEST(push_bulk_ring)
+    queue = queue_create_with_capacity(QUEUE_RING_MIN_CAPACITY);
+    FAIL(queue_push_bulk(queue, batch, QUEUE_RING_MIN_CAPACITY - 2) == false,
+         "queue_push_bulk() failed on ring buffer queue")
+    for (size_t i = 0; i < QUEUE_RING_MIN_CAPACITY - 4; i++) {
+        queue_pop(queue, &data);
+    }
+    FAIL(queue_push_bulk(queue, batch, 10) == false,
+         "queue_push_bulk() failed to wrap ring buffer queue")
+    FAIL(queue_push_bulk(queue, batch, 100) == false,
+         "queue_push_bulk() failed to grow ring buffer queue")
+    FAIL(queue_size(queue) != 112,
+         "queue_size() incorrect after queue_push_bulk() on ring buffer queue")
+    for (size_t i = QUEUE_RING_MIN_CAPACITY - 4; i < QUEUE_RING_MIN_CAPACITY - 2; i++) {
+        bool status = queue_pop(queue, &data);
+        FAIL(status == false || data != i,
+             "queue_pop() returned wrong data from ring buffer queue")
+    }
+    for (size_t i = 0; i < 10; i++) {
+        bool status = queue_pop(queue, &data);
+        FAIL(status == false || data != i,
+             "queue_pop() returned wrong data from wrapped batch")
+    }
+    for (size_t i = 0; i < 100; i++) {
+        bool status = queue_pop(queue, &data);
+        FAIL(status == false || data != i,
+             "queue_pop() returned wrong data from grown batch")
+    }
+    queue_delete(queue);
+
+    PASS(check_queue_push_bulk)
+#endif
+}
+
+void check_bulk_removal(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_remove_front_bulk)
+
+    unsigned int values[100];
+    unsigned int out[100];
+    size_t removed = SIZE_MAX;
+    for (size_t i = 0; i < 100; i++) {
+        values[i] = i;
+    }
+
+    SUBTEST(remove_front_bulk_empty)
+    struct linked_list * ll = linked_list_create();
+    FAIL(linked_list_remove_front_bulk(ll, out, 10, &removed) != false,
+         "linked_list_remove_front_bulk() succeeded on empty linked_list")
+    FAIL(removed != 0,
+         "linked_list_remove_front_bulk() did not report 0 removed")
+
+    SUBTEST(remove_front_bulk_partial)
+    linked_list_insert_end_bulk(ll, values, 100);
+    FAIL(linked_list_remove_front_bulk(ll, out, 30, &removed) == false,
+         "linked_list_remove_front_bulk() failed")
+    FAIL(removed != 30 || linked_list_size(ll) != 70,
+         "linked_list_remove_front_bulk() removed wrong number of elements")
+    for (size_t i = 0; i < 30; i++) {
+        FAIL(out[i] != i,
+             "linked_list_remove_front_bulk() returned data out of order")
+    }
+    FAIL(ll->head->data != 30,
+         "linked_list head incorrect after linked_list_remove_front_bulk()")
+
+    SUBTEST(remove_front_bulk_all)
+    FAIL(linked_list_remove_front_bulk(ll, out, 100, &removed) == false,
+         "linked_list_remove_front_bulk() failed")
+    FAIL(removed != 70 || out[69] != 99,
+         "linked_list_remove_front_bulk() did not drain the linked_list")
+    FAIL(ll->head != NULL || ll->tail != NULL || linked_list_size(ll) != 0,
+         "linked_list not empty after linked_list_remove_front_bulk()")
+    FAIL(linked_list_insert_end(ll, 5) == false || ll->head != ll->tail,
+         "linked_list unusable after linked_list_remove_front_bulk()")
+    linked_list_delete(ll);
+
+    PASS(check_linked_list_remove_front_bulk)
+#endif
+
+#ifdef TEST_QUEUE
+    TEST(check_queue_pop_bulk)
+
+    static unsigned int batch[3 * QUEUE_CHUNK_CAPACITY];
+    static unsigned int popped_values[3 * QUEUE_CHUNK_CAPACITY];
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY; i++) {
+        batch[i] = i;
+    }
+
+    SUBTEST(pop_bulk_arguments)
+    size_t popped = SIZE_MAX;
+    FAIL(queue_pop_bulk(NULL, popped_values, 1, &popped) != false || popped != 0,
+         "queue_pop_bulk(NULL, ...) did not fail")
+    struct queue * queue = queue_create();
+    FAIL(queue_pop_bulk(queue, popped_values, 1, &popped) != false || popped != 0,
+         "queue_pop_bulk() succeeded on empty queue")
+
+    // Pop windows that don't line up with chunk boundaries.
+    //
+    SUBTEST(pop_bulk_chunked)
+    queue_push_bulk(queue, batch, 3 * QUEUE_CHUNK_CAPACITY);
+    size_t expected = 0;
+    while (queue_pop_bulk(queue, popped_values, 1000, &popped)) {
+        for (size_t i = 0; i < popped; i++) {
+            FAIL(popped_values[i] != expected,
+                 "queue_pop_bulk() returned data out of order")
+            ++expected;
+        }
+    }
+    FAIL(expected != 3 * QUEUE_CHUNK_CAPACITY || queue_size(queue) != 0,
+         "queue_pop_bulk() did not drain chunked queue")
+    FAIL(queue_push(queue, 9) == false || queue_pop(queue, &popped_values[0]) == false ||
+         popped_values[0] != 9,
+         "chunked queue unusable after queue_pop_bulk()")
+    queue_delete(queue);
+
+    SUBTEST(pop_bulk_ring)
+    queue = queue_create_with_capacity(QUEUE_RING_MIN_CAPACITY);
+    queue_push_bulk(queue, batch, 12);
+    queue_pop_bulk(queue, popped_values, 10, &popped);
+    queue_push_bulk(queue, batch + 12, 12);
+    FAIL(queue_pop_bulk(queue, popped_values, 100, &popped) == false || popped != 14,
+         "queue_pop_bulk() popped wrong number of entries from ring buffer queue")
+    for (size_t i = 0; i < 14; i++) {
+        FAIL(popped_values[i] != i + 10,
+             "queue_pop_bulk() returned wrong data from wrapped ring buffer queue")
+    }
+    FAIL(queue_has_next(queue) != false,
+         "ring buffer queue not empty after queue_pop_bulk()")
+    queue_delete(queue);
+
+    PASS(check_queue_pop_bulk)
+#endif
+}
+
+void check_queue_clear(void) {
+#ifdef TEST_QUEUE
+    TEST(check_queue_clear)
+
+    static unsigned int batch[3 * QUEUE_CHUNK_CAPACITY];
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY; i++) {
+        batch[i] = i;
+    }
+    unsigned int data = 0;
+
+    SUBTEST(queue_clear_null)
+    FAIL(queue_clear(NULL) != false,
+         "queue_clear(NULL) did not return false")
+    FAIL(queue_set_high_water_mark(NULL, 0) != false,
+         "queue_set_high_water_mark(NULL, 0) did not return false")
+
+    // Once a chunked queue has held a batch, clearing it and pushing
+    // the same batch again must not allocate.
+    //
+    SUBTEST(queue_clear_chunked_keeps_memory)
+    struct queue * queue = queue_create();
+    FAIL(queue_push_bulk(queue, batch, 3 * QUEUE_CHUNK_CAPACITY) == false,
+         "queue_push_bulk() failed")
+    FAIL(queue_clear(queue) == false,
+         "queue_clear() failed on chunked queue")
+    FAIL(queue_size(queue) != 0 || queue_has_next(queue) != false ||
+         queue_pop(queue, &data) != false,
+         "chunked queue not empty after queue_clear()")
+    size_t malloc_calls = instrumented_malloc_invocations;
+    FAIL(queue_push_bulk(queue, batch, 3 * QUEUE_CHUNK_CAPACITY) == false,
+         "queue_push_bulk() failed after queue_clear()")
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "Pushing into a cleared chunked queue allocated memory")
+    FAIL(queue_pop(queue, &data) == false || data != 0,
+         "queue_pop() returned wrong data after queue_clear()")
+
+    // With a high water mark of one chunk, the rest have to be
+    // allocated again after a clear.
+    //
+    SUBTEST(queue_clear_chunked_high_water_mark)
+    FAIL(queue_set_high_water_mark(queue, QUEUE_CHUNK_CAPACITY) == false,
+         "queue_set_high_water_mark() failed on chunked queue")
+    queue_clear(queue);
+    malloc_calls = instrumented_malloc_invocations;
+    queue_push_bulk(queue, batch, 3 * QUEUE_CHUNK_CAPACITY);
+    FAIL(instrumented_malloc_invocations != malloc_calls + 2,
+         "Cleared chunked queue did not trim to its high water mark")
+    queue_delete(queue);
+
+    SUBTEST(queue_clear_ring_keeps_memory)
+    queue = queue_create_with_capacity(QUEUE_RING_MIN_CAPACITY);
+    queue_push_bulk(queue, batch, 1000);
+    queue_pop(queue, &data);
+    FAIL(queue_clear(queue) == false,
+         "queue_clear() failed on ring buffer queue")
+    FAIL(queue_size(queue) != 0 || queue_pop(queue, &data) != false,
+         "ring buffer queue not empty after queue_clear()")
+    malloc_calls = instrumented_malloc_invocations;
+    queue_push_bulk(queue, batch, 1000);
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "Pushing into a cleared ring buffer queue allocated memory")
+    FAIL(queue_pop(queue, &data) == false || data != 0,
+         "queue_pop() returned wrong data after queue_clear()")
+
+    SUBTEST(queue_clear_ring_high_water_mark)
+    queue_set_high_water_mark(queue, 100);
+    queue_clear(queue);
+    malloc_calls = instrumented_malloc_invocations;
+    queue_push_bulk(queue, batch, 128);
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "Ring buffer queue trimmed below its high water mark")
+    queue_push(queue, 128);
+    FAIL(instrumented_malloc_invocations != malloc_calls + 1,
+         "Ring buffer queue was not trimmed to its high water mark")
+    for (size_t i = 0; i <= 128; i++) {
+        FAIL(queue_pop(queue, &data) == false || data != i,
+             "queue_pop() returned wrong data after trimming")
+    }
+    queue_delete(queue);
+
+    PASS(check_queue_clear)
+#endif
+}
+
+void check_deque(void) {
+#ifdef TEST_QUEUE
+    TEST(check_deque)
+
+    unsigned int data = 0;
+
+    SUBTEST(deque_null)
+    FAIL(deque_push_front(NULL, 0) != false || deque_push_back(NULL, 0) != false,
+         "deque push accepted a NULL deque")
+    FAIL(deque_pop_front(NULL, &data) != false || deque_pop_back(NULL, &data) != false,
+         "deque pop accepted a NULL deque")
+    FAIL(deque_size(NULL) != SIZE_MAX || deque_delete(NULL) != false,
+         "deque functions accepted a NULL deque")
+
+    SUBTEST(deque_empty)
+    struct deque * deque = deque_create();
+    FAIL(deque == NULL,
+         "deque_create() failed")
+    FAIL(deque_pop_front(deque, &data) != false || deque_pop_back(deque, &data) != false,
+         "Empty deque returned data")
+    FAIL(deque_peek_front(deque, &data) != false || deque_peek_back(deque, &data) != false,
+         "Empty deque returned data")
+
+    // Grow well past a block in each direction, so the front and back
+    // are in different blocks, and check both ends.
+    //
+    SUBTEST(deque_both_ends)
+    size_t count = 3 * DEQUE_BLOCK_CAPACITY;
+    for (size_t i = 0; i < count; i++) {
+        FAIL(deque_push_back(deque, 1000000 + i) == false,
+             "deque_push_back() failed")
+        FAIL(deque_push_front(deque, 1000000 - 1 - i) == false,
+             "deque_push_front() failed")
+    }
+    FAIL(deque_size(deque) != 2 * count,
+         "deque_size() wrong after pushes")
+    unsigned int front = 0;
+    unsigned int back  = 0;
+    FAIL(deque_peek_front(deque, &front) == false || front != 1000000 - count ||
+         deque_peek_back(deque, &back) == false || back != 1000000 + count - 1,
+         "deque peek returned wrong data")
+
+    // Popping from the front runs through the blocks the back pushes
+    // made, and vice versa.
+    //
+    for (size_t i = 0; i < count + 10; i++) {
+        FAIL(deque_pop_front(deque, &data) == false || data != 1000000 - count + i,
+             "deque_pop_front() returned wrong data")
+    }
+    for (size_t i = 0; i < count - 10; i++) {
+        FAIL(deque_pop_back(deque, &data) == false || data != 1000000 + count - 1 - i,
+             "deque_pop_back() returned wrong data")
+    }
+    FAIL(deque_size(deque) != 0 || deque_pop_back(deque, &data) != false,
+         "deque not empty after popping everything")
+
+    // An emptied deque reuses its block from the middle, so pushing at
+    // either end afterwards must not allocate.
+    //
+    SUBTEST(deque_reuse)
+    size_t malloc_calls = instrumented_malloc_invocations;
+    for (size_t i = 0; i < DEQUE_BLOCK_CAPACITY / 2; i++) {
+        deque_push_front(deque, i);
+    }
+    for (size_t i = 0; i < DEQUE_BLOCK_CAPACITY / 2; i++) {
+        deque_push_back(deque, i);
+    }
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "Refilling an emptied deque allocated")
+    FAIL(deque_clear(deque) == false || deque_size(deque) != 0,
+         "deque_clear() failed")
+    FAIL(deque_push_back(deque, 7) == false || deque_peek_front(deque, &data) == false || data != 7,
+         "deque wrong after deque_clear()")
+    deque_delete(deque);
+
+    PASS(check_deque)
+#endif
+}
+
+void check_queue_inline(void) {
+#ifdef TEST_QUEUE
+    TEST(check_queue_inline)
+
+    unsigned int data = 0;
+
+    SUBTEST(queue_inline_null)
+    FAIL(queue_push_inline(NULL, 0) != false,
+         "queue_push_inline(NULL, 0) did not return false")
+    struct queue * queue = queue_create();
+    FAIL(queue_pop_inline(queue, &data) != false,
+         "queue_pop_inline() on empty queue did not return false")
+    FAIL(queue_pop_inline(queue, NULL) != false,
+         "queue_pop_inline(queue, NULL) did not return false")
+
+    // Interleave the inline and out-of-line functions across several
+    // chunk boundaries, then drain the queue the same way.
+    //
+    SUBTEST(queue_inline_chunked)
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY + 5; i++) {
+        bool status = (i % 3 == 0) ? queue_push(queue, i) : queue_push_inline(queue, i);
+        FAIL(status == false,
+             "queue_push_inline() failed on chunked queue")
+    }
+    FAIL(queue_size(queue) != 3 * QUEUE_CHUNK_CAPACITY + 5,
+         "queue_size() wrong after queue_push_inline()")
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY + 5; i++) {
+        bool status = (i % 5 == 0) ? queue_pop(queue, &data) : queue_pop_inline(queue, &data);
+        FAIL(status == false || data != i,
+             "queue_pop_inline() returned wrong data from chunked queue")
+    }
+    FAIL(queue_pop_inline(queue, &data) != false || queue_size(queue) != 0,
+         "Chunked queue not empty after draining with queue_pop_inline()")
+    queue_delete(queue);
+
+    // Start small so that pushes have to grow and wrap the ring.
+    //
+    SUBTEST(queue_inline_ring)
+    queue = queue_create_with_capacity(QUEUE_RING_MIN_CAPACITY);
+    unsigned int next = 0;
+    for (size_t round = 0; round < 4; round++) {
+        for (size_t i = 0; i < 3 * QUEUE_RING_MIN_CAPACITY; i++) {
+            FAIL(queue_push_inline(queue, round * 3 * QUEUE_RING_MIN_CAPACITY + i) == false,
+                 "queue_push_inline() failed on ring buffer queue")
+        }
+        for (size_t i = 0; i < 2 * QUEUE_RING_MIN_CAPACITY; i++) {
+            FAIL(queue_pop_inline(queue, &data) == false || data != next++,
+                 "queue_pop_inline() returned wrong data from ring buffer queue")
+        }
+    }
+    while (queue_pop_inline(queue, &data)) {
+        FAIL(data != next++,
+             "queue_pop_inline() returned wrong data while draining ring buffer queue")
+    }
+    FAIL(next != 4 * 3 * QUEUE_RING_MIN_CAPACITY,
+         "Ring buffer queue lost entries")
+    queue_delete(queue);
+
+    PASS(check_queue_inline)
+#endif
+}
+
+// A minimal bump arena used as an allocator context. Frees are only
+// counted, memory comes back when the arena is reset.
+//
+struct test_arena {
+    unsigned char * buffer;
+    size_t capacity;
+    size_t used;
+    size_t allocs;
+    size_t frees;
+};
+
+void * test_arena_alloc(void * state, size_t size) {
+    struct test_arena * arena = (struct test_arena *)state;
+    size = (size + 15) & ~(size_t)15;
+    if (arena->capacity - arena->used < size) {
+        return NULL;
+    }
+    void * ptr = arena->buffer + arena->used;
+    arena->used += size;
+    ++arena->allocs;
+    return ptr;
+}
+
+void test_arena_free(void * state, void * addr) {
+    struct test_arena * arena = (struct test_arena *)state;
+    (void)addr;
+    ++arena->frees;
+}
+
+void check_allocator_contexts(void) {
+    static _Alignas(16) unsigned char arena_buffer[1 << 18];
+    struct test_arena arena = { arena_buffer, sizeof(arena_buffer), 0, 0, 0 };
+    struct allocator allocator = { test_arena_alloc, test_arena_free, &arena };
+    struct allocator incomplete = { test_arena_alloc, NULL, &arena };
+    size_t malloc_calls = 0;
+
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_allocator_context)
+
+    SUBTEST(linked_list_create_with_allocator_null)
+    FAIL(linked_list_create_with_allocator(NULL) != NULL,
+         "linked_list_create_with_allocator(NULL) did not return NULL")
+    FAIL(linked_list_create_with_allocator(&incomplete) != NULL,
+         "linked_list_create_with_allocator() accepted a context without free")
+
+    // Every allocation, including the list, nodes and iterators, has
+    // to come from the context and none from the registered malloc().
+    //
+    SUBTEST(linked_list_uses_context)
+    malloc_calls = instrumented_malloc_invocations;
+    struct linked_list * ll = linked_list_create_with_allocator(&allocator);
+    FAIL(ll == NULL,
+         "linked_list_create_with_allocator() failed")
+    for (size_t i = 0; i < 100; i++) {
+        FAIL(linked_list_insert_end(ll, i) == false,
+             "linked_list_insert_end() failed")
+    }
+    unsigned int values[50];
+    for (size_t i = 0; i < 50; i++) {
+        values[i] = 100 + i;
+    }
+    FAIL(linked_list_insert_end_bulk(ll, values, 50) == false,
+         "linked_list_insert_end_bulk() failed")
+    FAIL(linked_list_insert(ll, 10, 1000) == false,
+         "linked_list_insert() failed")
+    struct iterator * iter = linked_list_create_iterator(ll, 0);
+    FAIL(iter == NULL,
+         "linked_list_create_iterator() failed")
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "linked_list with an allocator context called the registered malloc()")
+    FAIL(arena.allocs != 1 + 151 + 1,
+         "linked_list did not allocate through its allocator context")
+
+    SUBTEST(linked_list_frees_through_context)
+    FAIL(linked_list_remove(ll, 10) == false,
+         "linked_list_remove() failed")
+    size_t removed = 0;
+    FAIL(linked_list_remove_front_bulk(ll, values, 50, &removed) == false || removed != 50,
+         "linked_list_remove_front_bulk() failed")
+    FAIL(linked_list_size(ll) != 100 || linked_list_find(ll, 50) != 0,
+         "linked_list contents wrong after removal")
+    FAIL(linked_list_delete(ll) == false,
+         "Failed to delete linked_list")
+    FAIL(linked_list_delete_iterator(iter) == false,
+         "Failed to delete iterator after its linked_list")
+    FAIL(arena.frees != arena.allocs,
+         "linked_list did not free everything through its allocator context")
+
+    PASS(check_linked_list_allocator_context)
+#endif
+
+#ifdef TEST_QUEUE
+    TEST(check_queue_allocator_context)
+
+    arena.used   = 0;
+    arena.allocs = 0;
+    arena.frees  = 0;
+
+    SUBTEST(queue_create_with_allocator_null)
+    FAIL(queue_create_with_allocator(NULL) != NULL,
+         "queue_create_with_allocator(NULL) did not return NULL")
+    FAIL(queue_create_with_allocator(&incomplete) != NULL,
+         "queue_create_with_allocator() accepted a context without free")
+
+    SUBTEST(queue_uses_context)
+    malloc_calls = instrumented_malloc_invocations;
+    struct queue * queue = queue_create_with_allocator(&allocator);
+    FAIL(queue == NULL,
+         "queue_create_with_allocator() failed")
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY; i++) {
+        FAIL(queue_push(queue, i) == false,
+             "queue_push() failed")
+    }
+    unsigned int data = 0;
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY; i++) {
+        FAIL(queue_pop(queue, &data) == false || data != i,
+             "queue_pop() returned wrong data")
+    }
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "queue with an allocator context called the registered malloc()")
+    FAIL(arena.allocs != 1 + 3,
+         "queue did not allocate through its allocator context")
+
+    // Running the arena dry must fail the push, not fall back to malloc().
+    //
+    SUBTEST(queue_context_exhausted)
+    size_t used = arena.used;
+    arena.used  = arena.capacity;
+    queue_clear(queue);
+    queue_set_high_water_mark(queue, 0);
+    queue_clear(queue);
+    size_t pushed = 0;
+    while (queue_push(queue, pushed)) {
+        ++pushed;
+    }
+    FAIL(pushed > QUEUE_CHUNK_CAPACITY,
+         "queue_push() kept succeeding with an exhausted allocator context")
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "queue fell back to the registered malloc()")
+    arena.used = used;
+
+    SUBTEST(queue_frees_through_context)
+    FAIL(queue_delete(queue) == false,
+         "Failed to delete queue")
+    FAIL(arena.frees != arena.allocs,
+         "queue did not free everything through its allocator context")
+
+    PASS(check_queue_allocator_context)
+#endif
+
+    (void)malloc_calls;
+}
+
+// Typed containers generated by the DEFINE_* macros, for a 64-bit id
+// and for a (vertex, depth) pair.
+//
+struct visit {
+    unsigned int vertex;
+    unsigned int depth;
+};
+
+DEFINE_LINKED_LIST(u64_list, uint64_t)
+DEFINE_QUEUE(visit_queue, struct visit)
+DEFINE_QUEUE(uint_queue, unsigned int)
+
+void * test_heap_alloc(void * state, size_t size) {
+    (void)state;
+    return instrumented_malloc(size);
+}
+
+void test_heap_free(void * state, void * addr) {
+    (void)state;
+    free(addr);
+}
+
+void check_generic_containers(void) {
+    struct allocator heap = { test_heap_alloc, test_heap_free, NULL };
+
+#ifdef TEST_LINKED_LIST
+    TEST(check_generic_linked_list)
+
+    SUBTEST(generic_linked_list_null)
+    FAIL(u64_list_create(NULL) != NULL,
+         "u64_list_create(NULL) did not return NULL")
+    FAIL(u64_list_insert_end(NULL, 0) != false || u64_list_remove_front(NULL, NULL) != false,
+         "u64_list functions accepted a NULL list")
+    FAIL(u64_list_size(NULL) != SIZE_MAX,
+         "u64_list_size(NULL) did not return SIZE_MAX")
+
+    // Values above 32 bits must survive being stored in the list.
+    //
+    SUBTEST(generic_linked_list_u64)
+    struct u64_list * ll = u64_list_create(&heap);
+    FAIL(ll == NULL,
+         "u64_list_create() failed")
+    for (uint64_t i = 0; i < 100; i++) {
+        FAIL(u64_list_insert_end(ll, (i << 40) | i) == false,
+             "u64_list_insert_end() failed")
+    }
+    FAIL(u64_list_insert_front(ll, UINT64_MAX) == false,
+         "u64_list_insert_front() failed")
+    FAIL(u64_list_size(ll) != 101 || *u64_list_front(ll) != UINT64_MAX ||
+         *u64_list_back(ll) != ((UINT64_C(99) << 40) | 99),
+         "u64_list holds the wrong elements")
+    uint64_t value = 0;
+    FAIL(u64_list_remove_front(ll, &value) == false || value != UINT64_MAX,
+         "u64_list_remove_front() returned wrong data")
+    for (uint64_t i = 0; i < 50; i++) {
+        FAIL(u64_list_remove_front(ll, &value) == false || value != ((i << 40) | i),
+             "u64_list_remove_front() returned wrong data")
+    }
+    FAIL(u64_list_delete(ll) == false,
+         "u64_list_delete() failed")
+
+    PASS(check_generic_linked_list)
+#endif
+
+#ifdef TEST_QUEUE
+    TEST(check_generic_queue)
+
+    SUBTEST(generic_queue_null)
+    FAIL(visit_queue_create(NULL) != NULL,
+         "visit_queue_create(NULL) did not return NULL")
+    struct visit visit = { 0, 0 };
+    FAIL(visit_queue_push(NULL, visit) != false || visit_queue_pop(NULL, &visit) != false,
+         "visit_queue functions accepted a NULL queue")
+    FAIL(visit_queue_peek(NULL) != NULL || visit_queue_has_next(NULL) != false,
+         "visit_queue_peek(NULL) did not return NULL")
+
+    // Pairs are stored inline, across several chunk boundaries.
+    //
+    SUBTEST(generic_queue_pairs)
+    struct visit_queue * queue = visit_queue_create(&heap);
+    FAIL(queue == NULL,
+         "visit_queue_create() failed")
+    FAIL(visit_queue_pop(queue, &visit) != false || visit_queue_peek(queue) != NULL,
+         "Empty visit_queue returned data")
+    size_t count = 3 * visit_queue_chunk_capacity + 7;
+    for (size_t i = 0; i < count; i++) {
+        struct visit v = { (unsigned int)i, (unsigned int)(i / 3) };
+        FAIL(visit_queue_push(queue, v) == false,
+             "visit_queue_push() failed")
+    }
+    FAIL(visit_queue_size(queue) != count,
+         "visit_queue_size() wrong after pushes")
+    for (size_t i = 0; i < count; i++) {
+        struct visit * front = visit_queue_peek(queue);
+        FAIL(front == NULL || front->vertex != i,
+             "visit_queue_peek() returned wrong data")
+        FAIL(visit_queue_pop(queue, &visit) == false || visit.vertex != i || visit.depth != i / 3,
+             "visit_queue_pop() returned wrong data")
+    }
+    FAIL(visit_queue_has_next(queue) != false,
+         "visit_queue not empty after popping everything")
+
+    // A cleared queue keeps a spare chunk, so refilling one chunk's
+    // worth must not allocate.
+    //
+    SUBTEST(generic_queue_clear)
+    for (size_t i = 0; i < 2 * visit_queue_chunk_capacity; i++) {
+        visit_queue_push(queue, visit);
+    }
+    FAIL(visit_queue_clear(queue) == false || visit_queue_size(queue) != 0,
+         "visit_queue_clear() failed")
+    size_t malloc_calls = instrumented_malloc_invocations;
+    for (size_t i = 0; i < visit_queue_chunk_capacity; i++) {
+        struct visit v = { (unsigned int)i, 0 };
+        visit_queue_push(queue, v);
+    }
+    FAIL(instrumented_malloc_invocations != malloc_calls,
+         "visit_queue did not reuse its spare chunk")
+    FAIL(visit_queue_pop(queue, &visit) == false || visit.vertex != 0,
+         "visit_queue_pop() returned wrong data after clear")
+    visit_queue_delete(queue);
+
+    // The unsigned int instantiation behaves like struct queue.
+    //
+    SUBTEST(generic_queue_matches_queue)
+    struct uint_queue * typed = uint_queue_create(&heap);
+    struct queue * reference = queue_create();
+    for (size_t i = 0; i < 3 * QUEUE_CHUNK_CAPACITY; i++) {
+        uint_queue_push(typed, i);
+        queue_push(reference, i);
+        if (i % 3 == 0) {
+            unsigned int a = 0;
+            unsigned int b = 0;
+            FAIL(uint_queue_pop(typed, &a) != queue_pop(reference, &b) || a != b,
+                 "uint_queue_pop() and queue_pop() disagree")
+        }
+    }
+    FAIL(uint_queue_size(typed) != queue_size(reference),
+         "uint_queue_size() and queue_size() disagree")
+    uint_queue_delete(typed);
+    queue_delete(reference);
+
+    PASS(check_generic_queue)
+#endif
+
+    (void)heap;
+}
+
+// Predicate for linked_list_remove_if(): matches multiples of *ctx.
+//
+bool is_multiple_of(unsigned int data, void * ctx) {
+    return data % *(unsigned int *)ctx == 0;
+}
+
+void check_linked_list_remove_if(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_remove_if)
+
+    SUBTEST(remove_if_null)
+    unsigned int divisor = 3;
+    struct linked_list * ll = linked_list_create();
+    FAIL(linked_list_remove_if(NULL, is_multiple_of, &divisor) != SIZE_MAX,
+         "linked_list_remove_if(NULL, ...) did not return SIZE_MAX")
+    FAIL(linked_list_remove_if(ll, NULL, &divisor) != SIZE_MAX,
+         "linked_list_remove_if(ll, NULL, ...) did not return SIZE_MAX")
+    FAIL(linked_list_remove_if(ll, is_multiple_of, &divisor) != 0,
+         "linked_list_remove_if() removed from an empty linked_list")
+    linked_list_delete(ll);
+
+    // Remove multiples of 3, then of 2 (which takes the tail), then
+    // nothing, then everything, checking the contents and that the
+    // tail still accepts inserts after each pass.
+    //
+    enum { count = 4 * LINKED_LIST_CHUNK_CAPACITY + 6 };
+    static unsigned int expected[count + 4];
+    unsigned int divisors[] = { 3, 2, count * 4, 1 };
+    for (int mode = 0; mode < 2; mode++) {
+        SUBTEST(remove_if_matches)
+        ll = mode == 0 ? linked_list_create() : linked_list_create_indexed();
+        FAIL(ll == NULL,
+             "Failed to create linked_list")
+        size_t size = 0;
+        for (size_t i = 1; i <= count; i++) {
+            linked_list_insert_end(ll, (unsigned int)i);
+            expected[size++] = (unsigned int)i;
+        }
+        for (size_t d = 0; d < sizeof(divisors) / sizeof(divisors[0]); d++) {
+            size_t kept = 0;
+            for (size_t i = 0; i < size; i++) {
+                if (expected[i] % divisors[d] != 0) {
+                    expected[kept++] = expected[i];
+                }
+            }
+            FAIL(linked_list_remove_if(ll, is_multiple_of, &divisors[d]) != size - kept,
+                 "linked_list_remove_if() returned the wrong count")
+            size = kept;
+            FAIL(!linked_list_matches(ll, expected, size),
+                 "linked_list_remove_if() left the wrong elements")
+            FAIL(linked_list_insert_end(ll, 1) == false,
+                 "linked_list_insert_end() failed after linked_list_remove_if()")
+            expected[size++] = 1;
+            FAIL(!linked_list_matches(ll, expected, size),
+                 "Tail wrong after linked_list_remove_if()")
+        }
+        FAIL(mode == 1 && ll->chunk_count != 1,
+             "Indexed linked_list not compacted by linked_list_remove_if()")
+        linked_list_delete(ll);
+    }
+
+    // Nodes from an allocator context are freed one by one rather
+    // than handed to the pool.
+    //
+    SUBTEST(remove_if_allocator)
+    struct allocator heap = { test_heap_alloc, test_heap_free, NULL };
+    ll = linked_list_create_with_allocator(&heap);
+    for (unsigned int i = 0; i < 100; i++) {
+        linked_list_insert_end(ll, i);
+    }
+    divisor = 2;
+    FAIL(linked_list_remove_if(ll, is_multiple_of, &divisor) != 50 || linked_list_size(ll) != 50,
+         "linked_list_remove_if() failed on a linked_list with its own allocator")
+    FAIL(linked_list_find(ll, 99) != 49,
+         "linked_list_remove_if() left the wrong elements")
+    linked_list_delete(ll);
+
+    PASS(check_linked_list_remove_if)
+#endif
+}
+
+int compare_unsigned(const void * a, const void * b) {
+    unsigned int x = *(const unsigned int *)a;
+    unsigned int y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+void check_linked_list_sort(void) {
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_sort)
+
+    SUBTEST(sort_null)
+    FAIL(linked_list_sort(NULL) != false || linked_list_radix_sort(NULL) != false,
+         "Sorting a NULL linked_list did not return false")
+
+    // Every combination of storage, sort and input pattern, with
+    // lengths around chunk and power of two boundaries. The result must
+    // match qsort() and the tail must still accept inserts.
+    //
+    enum { max_count = 3 * LINKED_LIST_CHUNK_CAPACITY + 5 };
+    static unsigned int expected[max_count + 1];
+    size_t lengths[] = { 0, 1, 2, 3, 17, LINKED_LIST_CHUNK_CAPACITY, max_count };
+    unsigned int seed = 99;
+    for (int mode = 0; mode < 2; mode++) {
+        for (int radix = 0; radix < 2; radix++) {
+            for (int pattern = 0; pattern < 5; pattern++) {
+                for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+                    SUBTEST(sort_matches_qsort)
+                    size_t count = lengths[l];
+                    struct linked_list * ll = mode == 0 ? linked_list_create() : linked_list_create_indexed();
+                    FAIL(ll == NULL,
+                         "Failed to create linked_list")
+                    for (size_t i = 0; i < count; i++) {
+                        seed = seed * 1103515245u + 12345u;
+                        unsigned int values[] = { seed, (unsigned int)i, (unsigned int)(count - i),
+                                                  seed % 5, (seed % 3) << 24 };
+                        expected[i] = values[pattern];
+                        linked_list_insert_end(ll, expected[i]);
+                    }
+                    //leave some chunks of an indexed list partly filled
+                    if (count > 10) {
+                        linked_list_remove(ll, 5);
+                        memmove(&expected[5], &expected[6], (count - 6) * sizeof(unsigned int));
+                        count--;
+                    }
+                    bool sorted = radix ? linked_list_radix_sort(ll) : linked_list_sort(ll);
+                    FAIL(sorted == false,
+                         "Sorting the linked_list failed")
+                    qsort(expected, count, sizeof(unsigned int), compare_unsigned);
+                    FAIL(!linked_list_matches(ll, expected, count),
+                         "Sorted linked_list doesn't match qsort()")
+                    FAIL(linked_list_insert_end(ll, UINT_MAX) == false,
+                         "linked_list_insert_end() failed after sorting")
+                    expected[count] = UINT_MAX;
+                    FAIL(!linked_list_matches(ll, expected, count + 1),
+                         "Tail wrong after sorting")
+                    linked_list_delete(ll);
+                }
+            }
+        }
+    }
+
+    // Equal keys keep their original order: nodes are relinked, not
+    // copied, so their addresses show where they started.
+    //
+    for (int radix = 0; radix < 2; radix++) {
+        SUBTEST(sort_stable)
+        struct linked_list * ll = linked_list_create();
+        struct node * order[100];
+        for (unsigned int i = 0; i < 100; i++) {
+            linked_list_insert_end(ll, (i * 7) % 5);
+            order[i] = ll->tail;
+        }
+        FAIL((radix ? linked_list_radix_sort(ll) : linked_list_sort(ll)) == false,
+             "Sorting the linked_list failed")
+        size_t last_position[5] = { 0, 0, 0, 0, 0 };
+        for (struct node * curr = ll->head; curr != NULL; curr = curr->next) {
+            size_t position = 0;
+            while (order[position] != curr) {
+                position++;
+            }
+            FAIL(position < last_position[curr->data],
+                 "Sort reordered equal keys")
+            last_position[curr->data] = position;
+        }
+        linked_list_delete(ll);
+    }
+
+    PASS(check_linked_list_sort)
+#endif
+}
+
+void check_splice(void) {
+    struct allocator heap = { test_heap_alloc, test_heap_free, NULL };
+    (void)heap;
+
+#ifdef TEST_LINKED_LIST
+    TEST(check_linked_list_splice)
+
+    enum { list_count = 3 * LINKED_LIST_CHUNK_CAPACITY + 9 };
+    static unsigned int expected[2 * list_count];
+
+    SUBTEST(splice_refused)
+    struct linked_list * dst = linked_list_create();
+    struct linked_list * src = linked_list_create_indexed();
+    struct linked_list * other = linked_list_create_with_allocator(&heap);
+    linked_list_insert_end(src, 1);
+    linked_list_insert_end(other, 2);
+    FAIL(linked_list_splice(NULL, src) != false || linked_list_splice(dst, NULL) != false,
+         "linked_list_splice() accepted a NULL linked_list")
+    FAIL(linked_list_splice(dst, dst) != false,
+         "linked_list_splice() accepted the same linked_list twice")
+    FAIL(linked_list_splice(dst, src) != false,
+         "linked_list_splice() mixed node and indexed storage")
+    FAIL(linked_list_splice(dst, other) != false,
+         "linked_list_splice() mixed allocator contexts")
+    FAIL(linked_list_size(src) != 1 || linked_list_size(other) != 1,
+         "Refused linked_list_splice() changed src")
+    linked_list_delete(dst);
+    linked_list_delete(src);
+    linked_list_delete(other);
+
+    // Splice into an empty list, then onto a non-empty one, and keep
+    // using both lists afterwards.
+    //
+    for (int mode = 0; mode < 2; mode++) {
+        SUBTEST(splice_moves_elements)
+        dst = mode == 0 ? linked_list_create() : linked_list_create_indexed();
+        src = mode == 0 ? linked_list_create() : linked_list_create_indexed();
+        FAIL(dst == NULL || src == NULL,
+             "Failed to create linked_list")
+        for (size_t i = 0; i < list_count; i++) {
+            linked_list_insert_end(src, (unsigned int)i);
+            expected[i] = (unsigned int)i;
+        }
+        FAIL(linked_list_splice(dst, src) == false,
+             "linked_list_splice() into an empty linked_list failed")
+        FAIL(linked_list_size(src) != 0 || !linked_list_matches(src, expected, 0),
+             "linked_list_splice() didn't leave src empty")
+        FAIL(!linked_list_matches(dst, expected, list_count),
+             "linked_list_splice() into an empty linked_list lost elements")
+
+        //move the finger of dst forward before splicing behind it
+        FAIL(linked_list_insert(dst, 5, 500) == false || linked_list_remove(dst, 5) == false,
+             "linked_list_insert() or linked_list_remove() failed")
+        for (size_t i = 0; i < list_count; i++) {
+            linked_list_insert_end(src, (unsigned int)(list_count + i));
+            expected[list_count + i] = (unsigned int)(list_count + i);
+        }
+        FAIL(linked_list_splice(dst, src) == false,
+             "linked_list_splice() onto a non-empty linked_list failed")
+        FAIL(!linked_list_matches(dst, expected, 2 * list_count),
+             "linked_list_splice() onto a non-empty linked_list lost elements")
+        FAIL(linked_list_splice(dst, src) == false || linked_list_size(dst) != 2 * list_count,
+             "Splicing an empty linked_list changed dst")
+
+        //both lists stay usable
+        FAIL(linked_list_insert(dst, list_count + 1, 7) == false ||
+             linked_list_find(dst, 7) != 7 || linked_list_remove(dst, list_count + 1) == false,
+             "dst unusable after linked_list_splice()")
+        FAIL(linked_list_insert_end(src, 9) == false || linked_list_find(src, 9) != 0,
+             "src unusable after linked_list_splice()")
+        FAIL(!linked_list_matches(dst, expected, 2 * list_count),
+             "dst changed after being used")
+        linked_list_delete(dst);
+        linked_list_delete(src);
+    }
+
+    PASS(check_linked_list_splice)
+#endif
+
+#ifdef TEST_QUEUE
+    TEST(check_queue_append)
+
+    unsigned int data = 0;
+
+    SUBTEST(append_refused)
+    struct queue * chunked = queue_create();
+    struct queue * ring = queue_create_with_capacity(16);
+    struct queue * foreign = queue_create_with_allocator(&heap);
+    queue_push(ring, 1);
+    queue_push(foreign, 2);
+    FAIL(queue_append(NULL, ring) != false || queue_append(chunked, NULL) != false,
+         "queue_append() accepted a NULL queue")
+    FAIL(queue_append(chunked, chunked) != false,
+         "queue_append() accepted the same queue twice")
+    FAIL(queue_append(chunked, ring) != false,
+         "queue_append() mixed chunked and ring buffer storage")
+    FAIL(queue_append(chunked, foreign) != false,
+         "queue_append() mixed allocator contexts")
+    FAIL(queue_size(ring) != 1 || queue_size(foreign) != 1,
+         "Refused queue_append() changed src")
+    queue_delete(chunked);
+    queue_delete(ring);
+    queue_delete(foreign);
+
+    // Several frontiers of different lengths, each partly consumed so
+    // its head chunk starts mid-chunk, appended one after another so
+    // dst ends up with chunks cut short in the middle. Then drain dst
+    // with every pop flavour and check nothing was lost or reordered.
+    //
+    for (int storage = 0; storage < 2; storage++) {
+        SUBTEST(append_moves_entries)
+        struct queue * dst = storage == 0 ? queue_create() : queue_create_with_capacity(16);
+        struct queue * src = storage == 0 ? queue_create() : queue_create_with_capacity(16);
+        size_t lengths[] = { 10, QUEUE_CHUNK_CAPACITY + 3, 1, 2 * QUEUE_CHUNK_CAPACITY, 0, 37 };
+        unsigned int pushed = 0;
+        unsigned int skipped = 0;
+        for (size_t f = 0; f < sizeof(lengths) / sizeof(lengths[0]); f++) {
+            //entries that src consumes itself before the append
+            for (size_t i = 0; i < f; i++) {
+                queue_push(src, 0xdead);
+            }
+            for (size_t i = 0; i < lengths[f]; i++) {
+                queue_push(src, pushed++);
+            }
+            for (size_t i = 0; i < f; i++) {
+                queue_pop(src, &data);
+                skipped += data != 0xdead;
+            }
+            FAIL(queue_append(dst, src) == false,
+                 "queue_append() failed")
+            FAIL(queue_size(src) != 0 || queue_has_next(src),
+                 "queue_append() didn't leave src empty")
+        }
+        FAIL(skipped != 0 || queue_size(dst) != pushed,
+             "queue_append() lost entries")
+
+        //src and dst stay usable
+        FAIL(queue_push(src, 5) == false || queue_pop(src, &data) == false || data != 5,
+             "src unusable after queue_append()")
+        for (unsigned int i = 0; i < 100; i++) {
+            queue_push_inline(dst, pushed + i);
+        }
+        pushed += 100;
+
+        unsigned int next = 0;
+        unsigned int out[1000];
+        size_t popped = 0;
+        while (queue_has_next(dst)) {
+            if (next % 3 == 0) {
+                FAIL(queue_pop_bulk(dst, out, 1000, &popped) == false,
+                     "queue_pop_bulk() failed after queue_append()")
+                for (size_t i = 0; i < popped; i++) {
+                    FAIL(out[i] != next++,
+                         "queue_pop_bulk() returned wrong data after queue_append()")
+                }
+            }
+            else {
+                FAIL(queue_next(dst, &data) == false || data != next,
+                     "queue_next() returned wrong data after queue_append()")
+                FAIL(queue_pop_inline(dst, &data) == false || data != next++,
+                     "queue_pop_inline() returned wrong data after queue_append()")
+            }
+        }
+        FAIL(next != pushed,
+             "Appended queue didn't drain completely")
+        queue_delete(dst);
+        queue_delete(src);
+    }
+
+    PASS(check_queue_append)
+#endif
+}
+
+void check_spsc_queue(void) {
+#ifdef TEST_QUEUE
+    // Single threaded functional checks. The producer/consumer split
+    // is exercised by spsc_queue_performance.
+    //
+    TEST(check_spsc_queue)
+
+    SUBTEST(spsc_queue_null_handling)
+    unsigned int data = 7;
+    FAIL(spsc_queue_delete(NULL) != false,
+         "spsc_queue_delete(NULL) did not return false")
+    FAIL(spsc_queue_push(NULL, 1) != false,
+         "spsc_queue_push(NULL, 1) did not return false")
+    FAIL(spsc_queue_try_pop(NULL, &data) != false || data != 7,
+         "spsc_queue_try_pop(NULL, &data) did not fail cleanly")
+    FAIL(spsc_queue_size(NULL) != SIZE_MAX,
+         "spsc_queue_size(NULL) did not return SIZE_MAX")
+
+    SUBTEST(spsc_queue_empty)
+    struct spsc_queue * queue = spsc_queue_create(5);
+    FAIL(queue == NULL,
+         "Failed to create spsc_queue")
+    FAIL(spsc_queue_capacity(queue) != SPSC_QUEUE_MIN_CAPACITY,
+         "spsc_queue capacity not rounded up")
+    FAIL(spsc_queue_has_next(queue) != false || spsc_queue_size(queue) != 0,
+         "New spsc_queue is not empty")
+    FAIL(spsc_queue_try_pop(queue, &data) != false,
+         "spsc_queue_try_pop() succeeded on empty spsc_queue")
+
+    SUBTEST(spsc_queue_full)
+    for (unsigned int i = 0; i < SPSC_QUEUE_MIN_CAPACITY; i++) {
+        FAIL(spsc_queue_push(queue, i) == false,
+             "spsc_queue_push() failed before spsc_queue was full")
+    }
+    FAIL(spsc_queue_push(queue, 99) != false,
+         "spsc_queue_push() succeeded on full spsc_queue")
+    FAIL(spsc_queue_size(queue) != SPSC_QUEUE_MIN_CAPACITY,
+         "spsc_queue_size() incorrect on full spsc_queue")
+
+    // Keep pushing and popping so the indices wrap around the buffer
+    // several times.
+    //
+    SUBTEST(spsc_queue_wrap_around)
+    unsigned int expected = 0;
+    for (unsigned int i = SPSC_QUEUE_MIN_CAPACITY; i < 10 * SPSC_QUEUE_MIN_CAPACITY; i++) {
+        unsigned int next = 0;
+        FAIL(spsc_queue_next(queue, &next) == false || next != expected,
+             "spsc_queue_next() returned wrong data")
+        FAIL(spsc_queue_try_pop(queue, &data) == false || data != expected,
+             "spsc_queue_try_pop() returned wrong data")
+        ++expected;
+        FAIL(spsc_queue_push(queue, i) == false,
+             "spsc_queue_push() failed after a pop")
+    }
+    while (spsc_queue_try_pop(queue, &data)) {
+        FAIL(data != expected,
+             "spsc_queue_try_pop() returned wrong data while draining")
+        ++expected;
+    }
+    FAIL(expected != 10 * SPSC_QUEUE_MIN_CAPACITY,
+         "spsc_queue did not return every pushed value")
+
+    FAIL(spsc_queue_delete(queue) == false,
+         "Failed to delete spsc_queue")
+
+    PASS(check_spsc_queue)
+#endif
+}
+
+void check_mpmc_queue(void) {
+#ifdef TEST_QUEUE
+    // Single threaded functional checks. Concurrent use is exercised
+    // by mpmc_queue_performance.
+    //
+    TEST(check_mpmc_queue)
+
+    SUBTEST(mpmc_queue_null_handling)
+    unsigned int data = 7;
+    FAIL(mpmc_queue_delete(NULL) != false,
+         "mpmc_queue_delete(NULL) did not return false")
+    FAIL(mpmc_queue_push(NULL, 1) != false,
+         "mpmc_queue_push(NULL, 1) did not return false")
+    FAIL(mpmc_queue_pop(NULL, &data) != false || data != 7,
+         "mpmc_queue_pop(NULL, &data) did not fail cleanly")
+
+    SUBTEST(mpmc_queue_empty)
+    struct mpmc_queue * queue = mpmc_queue_create();
+    FAIL(queue == NULL,
+         "Failed to create mpmc_queue")
+    FAIL(mpmc_queue_has_next(queue) != false,
+         "mpmc_queue_has_next() returned true on empty mpmc_queue")
+    FAIL(mpmc_queue_pop(queue, &data) != false,
+         "mpmc_queue_pop() succeeded on empty mpmc_queue")
+
+    // Enough entries to span several segments, so that segments get
+    // appended, drained and retired.
+    //
+    SUBTEST(mpmc_queue_across_segments)
+    const unsigned int count = 5 * MPMC_QUEUE_SEGMENT_SIZE + 3;
+    for (unsigned int i = 0; i < count; i++) {
+        FAIL(mpmc_queue_push(queue, i) == false,
+             "mpmc_queue_push() failed")
+    }
+    FAIL(mpmc_queue_has_next(queue) == false,
+         "mpmc_queue_has_next() returned false on non-empty mpmc_queue")
+    for (unsigned int i = 0; i < count; i++) {
+        FAIL(mpmc_queue_pop(queue, &data) == false || data != i,
+             "mpmc_queue_pop() returned wrong data")
+    }
+    FAIL(mpmc_queue_pop(queue, &data) != false || mpmc_queue_has_next(queue) != false,
+         "mpmc_queue not empty after popping every entry")
+
+    SUBTEST(mpmc_queue_reuse)
+    FAIL(mpmc_queue_push(queue, 42) == false ||
+         mpmc_queue_pop(queue, &data) == false || data != 42,
+         "mpmc_queue unusable after being drained")
+
+    FAIL(mpmc_queue_delete(queue) == false,
+         "Failed to delete mpmc_queue")
+
+    PASS(check_mpmc_queue)
+#endif
+}
+
+#ifdef TEST_GRAPH
+// Returns true if a graph has exactly the given offsets and targets.
+//
+bool graph_matches(const struct graph * graph, uint32_t vertex_count, uint32_t edge_count,
+                   const uint32_t * offsets, const uint32_t * targets) {
+    return graph != NULL && graph->vertex_count == vertex_count &&
+           graph->edge_count == edge_count &&
+           memcmp(graph->offsets, offsets, ((size_t)vertex_count + 1) * sizeof(uint32_t)) == 0 &&
+           memcmp(graph->targets, targets, (size_t)edge_count * sizeof(uint32_t)) == 0;
+}
+
+// Writes length bytes to a new file at path.
+//
+bool write_test_file(const char * path, const void * data, size_t length) {
+    FILE * fptr = fopen(path, "wb");
+    if (fptr == NULL) {
+        return false;
+    }
+    bool status = fwrite(data, 1, length, fptr) == length;
+    return fclose(fptr) == 0 && status;
+}
+
+// Reads a whole file into a malloc()'d buffer.
+//
+unsigned char * read_test_file(const char * path, size_t * length) {
+    FILE * fptr = fopen(path, "rb");
+    if (fptr == NULL) {
+        return NULL;
+    }
+    fseek(fptr, 0, SEEK_END);
+    *length = (size_t)ftell(fptr);
+    fseek(fptr, 0, SEEK_SET);
+    unsigned char * data = malloc(*length + 1);
+    if (data != NULL && fread(data, 1, *length, fptr) != *length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fptr);
+    return data;
+}
+
+bool set_test_file_mtime(const char * path, time_t seconds) {
+    struct timespec times[2] = { { seconds, 0 }, { seconds, 0 } };
+    return utimensat(AT_FDCWD, path, times, 0) == 0;
+}
+
+// The graph cache checksum as described in graph.h, recomputed here so
+// a test can forge a file that passes it.
+//
+uint64_t graph_cache_checksum(const uint32_t * words, size_t count) {
+    uint64_t sum1 = 0;
+    uint64_t sum2 = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum1 += words[i];
+        sum2 += sum1;
+    }
+    return sum2 ^ (sum1 << 32) ^ (sum1 >> 32);
+}
+// Collects what mm_read_mtx_crd_stream() delivers.
+//
+struct stream_collector {
+    int count;
+    int batches;
+    int largest_batch;
+    int values;
+    bool val_was_null;
+    int stop_at_batch;
+    int I[64];
+    int J[64];
+    double val[128];
+};
+
+int collect_stream_entries(void * ctx, int count, const int I[], const int J[],
+                           const double val[]) {
+    struct stream_collector * collector = ctx;
+    collector->batches++;
+    if (count > collector->largest_batch) {
+        collector->largest_batch = count;
+    }
+    if (val == NULL) {
+        collector->val_was_null = true;
+    }
+    for (int k = 0; k < count && collector->count < 64; k++) {
+        collector->I[collector->count] = I[k];
+        collector->J[collector->count] = J[k];
+        for (int v = 0; v < collector->values && val != NULL; v++) {
+            collector->val[collector->values * collector->count + v] = val[collector->values * k + v];
+        }
+        collector->count++;
+    }
+    return collector->batches == collector->stop_at_batch ? 42 : 0;
+}
+
+// Streams text with the given matrix type into a collector.
+//
+int stream_test_entries(const char * text, const char * type, int batch_size,
+                        struct stream_collector * collector) {
+    MM_typecode code = { 'M', 'C', type[0], 'G' };
+    FILE * fptr = fmemopen((void *)text, strlen(text), "r");
+    if (fptr == NULL) {
+        return -1;
+    }
+    collector->values = type[0] == 'C' ? 2 : type[0] == 'P' ? 0 : 1;
+    int status = mm_read_mtx_crd_stream(fptr, code, collect_stream_entries, collector, batch_size);
+    fclose(fptr);
+    return status;
+}
+#endif
+
+void check_graph(void) {
+#ifdef TEST_GRAPH
+    TEST(check_graph)
+
+    // Vertex 2 has three out-edges spread over the list, vertices 3
+    // and 4 have none.
+    //
+    const uint32_t sources[]  = { 2, 0, 2, 1, 2, 0 };
+    const uint32_t targets[]  = { 3, 1, 0, 2, 1, 3 };
+    const uint32_t offsets[]  = { 0, 2, 3, 6, 6, 6 };
+    const uint32_t expected[] = { 1, 3, 2, 3, 0, 1 };
+
+    SUBTEST(graph_create_keeps_edge_order)
+    struct graph * graph = graph_create(5, 6, sources, targets);
+    FAIL(graph == NULL,
+         "graph_create() failed")
+    FAIL(!graph_matches(graph, 5, 6, offsets, expected),
+         "graph_create() built the wrong offsets or targets")
+    FAIL(graph->mapping != NULL,
+         "graph_create() returned a mapped graph")
+
+    SUBTEST(graph_degree_and_neighbors)
+    FAIL(graph_degree(graph, 2) != 3 || graph_neighbors(graph, 2)[0] != 3 ||
+         graph_neighbors(graph, 2)[1] != 0 || graph_neighbors(graph, 2)[2] != 1,
+         "Wrong out-edges of vertex 2")
+    FAIL(graph_degree(graph, 3) != 0 || graph_degree(graph, 4) != 0,
+         "Vertex without out-edges has a non-zero degree")
+    FAIL(graph_delete(graph) == false,
+         "Failed to delete graph")
+
+    SUBTEST(graph_create_without_edges)
+    graph = graph_create(3, 0, NULL, NULL);
+    FAIL(graph == NULL || graph_degree(graph, 0) != 0 || graph_degree(graph, 2) != 0,
+         "graph_create() failed on an empty edge list")
+    graph_delete(graph);
+
+    SUBTEST(graph_create_refused)
+    const uint32_t bad_sources[] = { 0, 5 };
+    const uint32_t bad_targets[] = { 5, 0 };
+    FAIL(graph_create(5, 2, bad_sources, targets) != NULL,
+         "graph_create() accepted an out-of-range source")
+    FAIL(graph_create(5, 2, sources, bad_targets) != NULL,
+         "graph_create() accepted an out-of-range target")
+    FAIL(graph_create(0, 0, NULL, NULL) != NULL,
+         "graph_create() accepted vertex_count == 0")
+    FAIL(graph_create(5, 6, NULL, targets) != NULL || graph_create(5, 6, sources, NULL) != NULL,
+         "graph_create() accepted a NULL edge list")
+    FAIL(graph_delete(NULL) != false,
+         "graph_delete(NULL) did not return false")
+
+    PASS(check_graph)
+#endif
+}
+
+void check_graph_cache(void) {
+#ifdef TEST_GRAPH
+    TEST(check_graph_cache)
+
+    char directory[] = "/tmp/graph_cache_testXXXXXX";
+    FAIL(mkdtemp(directory) == NULL,
+         "Failed to create a scratch directory")
+    char cache_path[64], bad_path[64], mtx_path[64];
+    snprintf(cache_path, sizeof(cache_path), "%s/graph.csr", directory);
+    snprintf(bad_path, sizeof(bad_path), "%s/bad.csr", directory);
+    snprintf(mtx_path, sizeof(mtx_path), "%s/graph.mtx", directory);
+
+    const uint32_t sources[]  = { 2, 0, 2, 1, 2, 0 };
+    const uint32_t targets[]  = { 3, 1, 0, 2, 1, 3 };
+    const uint32_t offsets[]  = { 0, 2, 3, 6, 6, 6 };
+    const uint32_t expected[] = { 1, 3, 2, 3, 0, 1 };
+    struct graph * graph = graph_create(5, 6, sources, targets);
+    FAIL(graph == NULL,
+         "graph_create() failed")
+
+    SUBTEST(graph_save_and_map)
+    FAIL(graph_save(graph, cache_path) == false,
+         "graph_save() failed")
+    struct graph * mapped = graph_map(cache_path);
+    FAIL(mapped == NULL || mapped->mapping == NULL,
+         "graph_map() failed on a fresh cache file")
+    FAIL(!graph_matches(mapped, 5, 6, offsets, expected),
+         "Mapped graph differs from the saved one")
+    FAIL(graph_delete(mapped) == false,
+         "Failed to delete mapped graph")
+    FAIL(graph_save(NULL, cache_path) != false || graph_save(graph, NULL) != false ||
+         graph_map(NULL) != NULL,
+         "graph_save() or graph_map() accepted NULL")
+
+    // Each variant is a valid cache with one thing wrong. The unchanged
+    // copy must still map, so a rejection isn't down to the copy.
+    //
+    SUBTEST(graph_map_rejects_corruption)
+    size_t length = 0;
+    unsigned char * file = read_test_file(cache_path, &length);
+    FAIL(file == NULL || length != sizeof(struct graph_cache_header) + (6 + 6) * sizeof(uint32_t),
+         "Cache file has the wrong size")
+    unsigned char * copy = malloc(length);
+    uint32_t * copy_words = (uint32_t *)(copy + sizeof(struct graph_cache_header));
+    struct graph_cache_header header;
+    for (int variant = 0; variant < 6; variant++) {
+        size_t copy_length = length;
+        memcpy(copy, file, length);
+        memcpy(&header, copy, sizeof(header));
+        if (variant == 1) {
+            copy[length - 1] ^= 0x01;
+        } else if (variant == 2) {
+            copy_length -= sizeof(uint32_t);
+        } else if (variant == 3) {
+            header.version++;
+        } else if (variant == 4) {
+            header.magic[0] ^= 0x01;
+        } else if (variant == 5) {
+            //point an edge past the last vertex and make the checksum agree
+            copy_words[6 + 5] = 5;
+            header.checksum = graph_cache_checksum(copy_words, 6 + 6);
+        }
+        if (variant >= 3) {
+            memcpy(copy, &header, sizeof(header));
+        }
+        FAIL(write_test_file(bad_path, copy, copy_length) == false,
+             "Failed to write cache copy")
+        mapped = graph_map(bad_path);
+        FAIL((variant == 0) != (mapped != NULL),
+             "graph_map() accepted a corrupt cache or refused a good one")
+        graph_delete(mapped);
+    }
+    free(copy);
+    free(file);
+
+    // The .mtx holds a different, smaller graph than the cache, so the
+    // result tells which file was read.
+    //
+    SUBTEST(graph_load_picks_current_file)
+    const char * mtx = "%%MatrixMarket matrix coordinate pattern general\n"
+                       "3 3 2\n"
+                       "1 2\n"
+                       "2 3\n";
+    const uint32_t mtx_offsets[] = { 0, 0, 1, 2, 2 };
+    const uint32_t mtx_targets[] = { 2, 3 };
+    FAIL(write_test_file(mtx_path, mtx, strlen(mtx)) == false,
+         "Failed to write .mtx file")
+    FAIL(set_test_file_mtime(mtx_path, 1000000) == false ||
+         set_test_file_mtime(cache_path, 1000000 - 100) == false,
+         "Failed to set file times")
+    struct graph * loaded = graph_load(mtx_path, cache_path);
+    FAIL(loaded == NULL || loaded->mapping != NULL ||
+         !graph_matches(loaded, 4, 2, mtx_offsets, mtx_targets),
+         "graph_load() used a cache older than the .mtx file")
+    graph_delete(loaded);
+
+    FAIL(set_test_file_mtime(cache_path, 1000000 + 100) == false,
+         "Failed to set file times")
+    loaded = graph_load(mtx_path, cache_path);
+    FAIL(loaded == NULL || loaded->mapping == NULL ||
+         !graph_matches(loaded, 5, 6, offsets, expected),
+         "graph_load() didn't use a cache newer than the .mtx file")
+    graph_delete(loaded);
+
+    loaded = graph_load(mtx_path, NULL);
+    FAIL(loaded == NULL || loaded->mapping != NULL,
+         "graph_load() without a cache path didn't read the .mtx file")
+    graph_delete(loaded);
+
+    //a newer but corrupt cache falls back to the .mtx file
+    FAIL(set_test_file_mtime(bad_path, 1000000 + 100) == false,
+         "Failed to set file times")
+    loaded = graph_load(mtx_path, bad_path);
+    FAIL(loaded == NULL || loaded->mapping != NULL ||
+         !graph_matches(loaded, 4, 2, mtx_offsets, mtx_targets),
+         "graph_load() didn't fall back from a corrupt cache")
+    graph_delete(loaded);
+
+    graph_delete(graph);
+    remove(cache_path);
+    remove(bad_path);
+    remove(mtx_path);
+    rmdir(directory);
+
+    PASS(check_graph_cache)
+#endif
+}
+
+void check_graph_mtx_threads(void) {
+#ifdef TEST_GRAPH
+    TEST(check_graph_mtx_threads)
+
+    char directory[] = "/tmp/graph_mtx_testXXXXXX";
+    FAIL(mkdtemp(directory) == NULL,
+         "Failed to create a scratch directory")
+    char mtx_path[64];
+    snprintf(mtx_path, sizeof(mtx_path), "%s/graph.mtx", directory);
+    const unsigned int thread_counts[] = { 1, 2, 3, 8 };
+
+    // CRLF and LF line ends, blank lines between entries and no newline
+    // after the last one.
+    //
+    SUBTEST(graph_load_mtx_threads_small)
+    const char * mtx = "%%MatrixMarket matrix coordinate real general\n"
+                       "4 4 6\n"
+                       "3 4 0.5\r\n"
+                       "1 2 -1\r\n"
+                       "\r\n"
+                       "3 1   2e3 \n"
+                       "\n"
+                       "\t2 3 7\n"
+                       "3 2 1\r\n"
+                       "1 4 0.25";
+    const uint32_t sources[] = { 3, 1, 3, 2, 3, 1 };
+    const uint32_t targets[] = { 4, 2, 1, 3, 2, 4 };
+    struct graph * expected = graph_create(5, 6, sources, targets);
+    FAIL(expected == NULL || write_test_file(mtx_path, mtx, strlen(mtx)) == false,
+         "Failed to set up the test graph")
+    for (int t = 0; t < 4; t++) {
+        struct graph * graph = graph_load_mtx_threads(mtx_path, thread_counts[t]);
+        FAIL(!graph_matches(graph, 5, 6, expected->offsets, expected->targets),
+             "graph_load_mtx_threads() differs from graph_create()")
+        graph_delete(graph);
+    }
+    graph_delete(expected);
+
+    // Enough vertices that the parallel build spreads them over more
+    // than one vertex per bucket.
+    //
+    SUBTEST(graph_load_mtx_threads_large)
+    const uint32_t vertex_count = 10000;
+    const uint32_t edge_count   = 40000;
+    uint32_t * large_sources = malloc(edge_count * sizeof(uint32_t));
+    uint32_t * large_targets = malloc(edge_count * sizeof(uint32_t));
+    char * text = malloc((size_t)edge_count * 16 + 128);
+    FAIL(large_sources == NULL || large_targets == NULL || text == NULL,
+         "Out of memory")
+    int length = sprintf(text, "%%%%MatrixMarket matrix coordinate pattern general\n%u %u %u\n",
+                         vertex_count, vertex_count, edge_count);
+    uint32_t state = 12345;
+    for (uint32_t e = 0; e < edge_count; e++) {
+        state = state * 1103515245 + 12345;
+        large_sources[e] = 1 + (state >> 8) % vertex_count;
+        state = state * 1103515245 + 12345;
+        large_targets[e] = 1 + (state >> 8) % vertex_count;
+        length += sprintf(text + length, "%u %u\n", large_sources[e], large_targets[e]);
+    }
+    expected = graph_create(vertex_count + 1, edge_count, large_sources, large_targets);
+    FAIL(expected == NULL || write_test_file(mtx_path, text, (size_t)length) == false,
+         "Failed to set up the test graph")
+    for (int t = 0; t < 4; t++) {
+        struct graph * graph = graph_load_mtx_threads(mtx_path, thread_counts[t]);
+        FAIL(!graph_matches(graph, vertex_count + 1, edge_count, expected->offsets, expected->targets),
+             "graph_load_mtx_threads() differs from graph_create()")
+        graph_delete(graph);
+    }
+    graph_delete(expected);
+    free(large_sources);
+    free(large_targets);
+    free(text);
+
+    // Each of these is refused by the mapped path at every thread count
+    // and by graph_read_mtx().
+    //
+    SUBTEST(graph_load_mtx_threads_refused)
+    const char * bad[] = {
+        //fewer entries than the header promises
+        "%%MatrixMarket matrix coordinate pattern general\n3 3 3\n1 2\n2 3\n",
+        //a real entry without its value
+        "%%MatrixMarket matrix coordinate real general\n3 3 2\n1 2 0.5\n2 3\n",
+        //a pattern entry with a value
+        "%%MatrixMarket matrix coordinate pattern general\n3 3 2\n1 2\n2 3 0.5\n",
+        //a complex entry with only one value
+        "%%MatrixMarket matrix coordinate complex general\n3 3 2\n1 2 0.5 1\n2 3 0.5\n",
+        //an index past the size line
+        "%%MatrixMarket matrix coordinate pattern general\n3 3 2\n1 2\n2 4\n",
+    };
+    for (size_t b = 0; b < sizeof(bad) / sizeof(bad[0]); b++) {
+        FAIL(write_test_file(mtx_path, bad[b], strlen(bad[b])) == false,
+             "Failed to write .mtx file")
+        for (int t = 0; t < 4; t++) {
+            struct graph * graph = graph_load_mtx_threads(mtx_path, thread_counts[t]);
+            FAIL(graph != NULL,
+                 "graph_load_mtx_threads() accepted a malformed file")
+        }
+        FILE * fptr = fopen(mtx_path, "r");
+        FAIL(fptr == NULL,
+             "Failed to open .mtx file")
+        struct graph * graph = graph_read_mtx(fptr);
+        fclose(fptr);
+        FAIL(graph != NULL,
+             "graph_read_mtx() accepted a malformed file")
+    }
+
+    remove(mtx_path);
+    rmdir(directory);
+
+    PASS(check_graph_mtx_threads)
+#endif
+}
+
+void check_mmio_readers(void) {
+#ifdef TEST_GRAPH
+    TEST(check_mmio_readers)
+
+    MM_typecode real_code    = { 'M', 'C', 'R', 'G' };
+    MM_typecode pattern_code = { 'M', 'C', 'P', 'G' };
+    MM_typecode complex_code = { 'M', 'C', 'C', 'G' };
+    char line[128];
+    int i, j, status;
+    double real, imag;
+
+    // Values on the fast path and ones that must go to strtod(), which
+    // both have to round the same way.
+    //
+    SUBTEST(mm_read_mtx_crd_entry_values)
+    const char * values[] = {
+        "0.1", "1e-5", "1e22", "1e23", "-1.5e-22", "9007199254740992",
+        "9007199254740993", "-0", "12345678901234567890",
+        "0.12345678901234567891", "1E+3", "inf", "0x1p-3",
+    };
+    for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+        snprintf(line, sizeof(line), "3 -7 %s\n", values[v]);
+        FILE * fptr = fmemopen(line, strlen(line), "r");
+        FAIL(fptr == NULL,
+             "fmemopen() failed")
+        status = mm_read_mtx_crd_entry(fptr, &i, &j, &real, &imag, real_code);
+        fclose(fptr);
+        double expected = strtod(values[v], NULL);
+        FAIL(status != 0 || i != 3 || j != -7,
+             "mm_read_mtx_crd_entry() failed on a valid entry")
+        FAIL(memcmp(&real, &expected, sizeof(double)) != 0,
+             "mm_read_mtx_crd_entry() and strtod() disagree")
+    }
+
+    SUBTEST(mm_read_mtx_crd_entry_refused)
+    const char * bad[] = {
+        "1 2 1e\n", "1 2 .\n", "1 2 -\n", "1 2 0.5x\n", "2147483648 1 1.0\n",
+        "1 -2147483649 1.0\n", "1 2\n", "1 2 \r\n", "1\n",
+    };
+    for (size_t b = 0; b < sizeof(bad) / sizeof(bad[0]); b++) {
+        snprintf(line, sizeof(line), "%s", bad[b]);
+        FILE * fptr = fmemopen(line, strlen(line), "r");
+        FAIL(fptr == NULL,
+             "fmemopen() failed")
+        status = mm_read_mtx_crd_entry(fptr, &i, &j, &real, &imag, real_code);
+        fclose(fptr);
+        FAIL(status != MM_PREMATURE_EOF,
+             "mm_read_mtx_crd_entry() didn't refuse a malformed entry")
+    }
+
+    SUBTEST(mm_read_mtx_crd_entry_int_limits)
+    snprintf(line, sizeof(line), "2147483647 -2147483648 1\n");
+    FILE * fptr = fmemopen(line, strlen(line), "r");
+    status = mm_read_mtx_crd_entry(fptr, &i, &j, &real, &imag, real_code);
+    fclose(fptr);
+    FAIL(status != 0 || i != INT_MAX || j != INT_MIN,
+         "mm_read_mtx_crd_entry() refused INT_MAX or INT_MIN")
+
+    // Entries may be split by CRLF line ends and blank lines.
+    //
+    SUBTEST(mm_read_mtx_crd_data_line_ends)
+    int rows[3], columns[3];
+    double data[6];
+    snprintf(line, sizeof(line), "1 2 0.5\r\n\r\n\n2 3 -1\r\n  \n3 1 1e23");
+    fptr = fmemopen(line, strlen(line), "r");
+    status = mm_read_mtx_crd_data(fptr, 3, 3, 3, rows, columns, data, real_code);
+    fclose(fptr);
+    FAIL(status != 0 || rows[0] != 1 || columns[0] != 2 || data[0] != 0.5 ||
+         rows[1] != 2 || columns[1] != 3 || data[1] != -1 ||
+         rows[2] != 3 || columns[2] != 1 || data[2] != 1e23,
+         "mm_read_mtx_crd_data() misread a real matrix")
+
+    snprintf(line, sizeof(line), "1 2\r\n\r\n2 3\n\n3 1\n");
+    fptr = fmemopen(line, strlen(line), "r");
+    status = mm_read_mtx_crd_data(fptr, 3, 3, 3, rows, columns, NULL, pattern_code);
+    fclose(fptr);
+    FAIL(status != 0 || rows[0] != 1 || columns[0] != 2 || rows[1] != 2 ||
+         columns[1] != 3 || rows[2] != 3 || columns[2] != 1,
+         "mm_read_mtx_crd_data() misread a pattern matrix")
+
+    snprintf(line, sizeof(line), "1 2 0.5 -2\r\n\r\n3 1 0 1e-5\r\n");
+    fptr = fmemopen(line, strlen(line), "r");
+    status = mm_read_mtx_crd_data(fptr, 3, 3, 2, rows, columns, data, complex_code);
+    fclose(fptr);
+    FAIL(status != 0 || rows[0] != 1 || columns[0] != 2 || data[0] != 0.5 ||
+         data[1] != -2 || rows[1] != 3 || columns[1] != 1 || data[2] != 0 ||
+         data[3] != 1e-5,
+         "mm_read_mtx_crd_data() misread a complex matrix")
+
+    SUBTEST(mm_read_mtx_crd_data_truncated)
+    snprintf(line, sizeof(line), "1 2 0.5\n2 3\n");
+    fptr = fmemopen(line, strlen(line), "r");
+    status = mm_read_mtx_crd_data(fptr, 3, 3, 2, rows, columns, data, real_code);
+    fclose(fptr);
+    FAIL(status != MM_PREMATURE_EOF,
+         "mm_read_mtx_crd_data() accepted a truncated entry")
+
+    snprintf(line, sizeof(line), "1 2 0.5\n");
+    fptr = fmemopen(line, strlen(line), "r");
+    status = mm_read_mtx_crd_data(fptr, 3, 3, 2, rows, columns, data, real_code);
+    fclose(fptr);
+    FAIL(status != MM_PREMATURE_EOF,
+         "mm_read_mtx_crd_data() accepted fewer than nz entries")
+
+    PASS(check_mmio_readers)
+#endif
+}
+
+void check_mmio_stream(void) {
+#ifdef TEST_GRAPH
+    TEST(check_mmio_stream)
+
+    // 20 entries, so batches of 1 and 7 each leave a short last batch.
+    //
+    char text[512];
+    int length = 0;
+    for (int e = 0; e < 20; e++) {
+        length += sprintf(text + length, e % 3 == 0 ? "%d %d %d.5\r\n\n" : "%d %d %d.5\n",
+                          e + 1, 20 - e, e);
+    }
+
+    SUBTEST(mm_read_mtx_crd_stream_batch_sizes)
+    const int batch_sizes[] = { 1, 7, 0, -3 };
+    for (int b = 0; b < 4; b++) {
+        struct stream_collector collector = { 0 };
+        int status = stream_test_entries(text, "R", batch_sizes[b], &collector);
+        int limit = batch_sizes[b] > 0 ? batch_sizes[b] : MM_STREAM_BATCH_SIZE;
+        FAIL(status != 0 || collector.count != 20,
+             "mm_read_mtx_crd_stream() didn't deliver every entry")
+        FAIL(collector.largest_batch > limit || collector.val_was_null ||
+             collector.batches != (20 + limit - 1) / limit,
+             "mm_read_mtx_crd_stream() delivered the wrong batches")
+        for (int e = 0; e < 20; e++) {
+            FAIL(collector.I[e] != e + 1 || collector.J[e] != 20 - e || collector.val[e] != e + 0.5,
+                 "mm_read_mtx_crd_stream() delivered entries out of order")
+        }
+    }
+
+    SUBTEST(mm_read_mtx_crd_stream_pattern_and_complex)
+    struct stream_collector pattern = { 0 };
+    FAIL(stream_test_entries("1 2\n3 4\n", "P", 0, &pattern) != 0 || pattern.count != 2 ||
+         !pattern.val_was_null || pattern.I[1] != 3 || pattern.J[1] != 4,
+         "mm_read_mtx_crd_stream() misread a pattern matrix")
+    struct stream_collector complex = { 0 };
+    FAIL(stream_test_entries("1 2 0.5 -1\n3 4 2 1e-5\n", "C", 1, &complex) != 0 ||
+         complex.count != 2 || complex.val[0] != 0.5 || complex.val[1] != -1 ||
+         complex.val[2] != 2 || complex.val[3] != 1e-5,
+         "mm_read_mtx_crd_stream() misread a complex matrix")
+    struct stream_collector integer = { 0 };
+    FAIL(stream_test_entries("1 2 7\n", "I", 0, &integer) != 0 || integer.count != 1 ||
+         integer.val[0] != 7,
+         "mm_read_mtx_crd_stream() misread an integer matrix")
+
+    SUBTEST(mm_read_mtx_crd_stream_stopped)
+    struct stream_collector stopped = { .stop_at_batch = 2 };
+    FAIL(stream_test_entries(text, "R", 7, &stopped) != 42 || stopped.batches != 2 ||
+         stopped.count != 14,
+         "mm_read_mtx_crd_stream() didn't stop on the callback's return value")
+
+    SUBTEST(mm_read_mtx_crd_stream_malformed)
+    struct stream_collector malformed = { 0 };
+    FAIL(stream_test_entries("1 2 0.5\n2 3 1\n3 4 1\n4 x 1\n5 6 1\n", "R", 2, &malformed) !=
+         MM_PREMATURE_EOF || malformed.count != 3 || malformed.I[2] != 3,
+         "mm_read_mtx_crd_stream() lost the entries before a malformed one")
+    struct stream_collector cut_off = { 0 };
+    FAIL(stream_test_entries("1 2 0.5\n2 3", "R", 0, &cut_off) != MM_PREMATURE_EOF ||
+         cut_off.count != 1,
+         "mm_read_mtx_crd_stream() accepted a cut off entry")
+    struct stream_collector unsupported = { 0 };
+    FAIL(stream_test_entries("1 2\n", "X", 0, &unsupported) != MM_UNSUPPORTED_TYPE ||
+         unsupported.batches != 0,
+         "mm_read_mtx_crd_stream() accepted an unknown matrix type")
+
+    SUBTEST(graph_read_mtx_small)
+    const char * mtx = "%%MatrixMarket matrix coordinate real general\n"
+                       "% a comment\n"
+                       "3 3 3\n"
+                       "1 2 0.5\r\n"
+                       "\n"
+                       "3 1 2\n"
+                       "1 3 -1";
+    const uint32_t offsets[] = { 0, 0, 2, 2, 3 };
+    const uint32_t targets[] = { 2, 3, 1 };
+    FILE * fptr = fmemopen((void *)mtx, strlen(mtx), "r");
+    struct graph * graph = graph_read_mtx(fptr);
+    fclose(fptr);
+    FAIL(!graph_matches(graph, 4, 3, offsets, targets),
+         "graph_read_mtx() misread a small file")
+    graph_delete(graph);
+
+    const char * short_mtx = "%%MatrixMarket matrix coordinate pattern general\n"
+                             "3 3 3\n"
+                             "1 2\n"
+                             "3 1\n";
+    fptr = fmemopen((void *)short_mtx, strlen(short_mtx), "r");
+    FAIL(graph_read_mtx(fptr) != NULL,
+         "graph_read_mtx() accepted fewer than nz entries")
+    fclose(fptr);
+    FAIL(graph_read_mtx(NULL) != NULL,
+         "graph_read_mtx(NULL) didn't return NULL")
+
+    PASS(check_mmio_stream)
+#endif
+}
+
 int main(void) {
     // Set up signal handler for catching infinite loops.
     //
@@ -567,8 +3062,16 @@ int main(void) {
     //
     linked_list_register_malloc(&instrumented_malloc);
     linked_list_register_free(&free);
+    arena_list_register_malloc(&instrumented_malloc);
+    arena_list_register_free(&free);
     queue_register_malloc(&instrumented_malloc);
     queue_register_free(&free);
+    deque_register_malloc(&instrumented_malloc);
+    deque_register_free(&free);
+    spsc_queue_register_malloc(&instrumented_malloc);
+    spsc_queue_register_free(&free);
+    mpmc_queue_register_malloc(&instrumented_malloc);
+    mpmc_queue_register_free(&free);
 
     check_null_handling();
     check_empty_list_and_queue_properties();
@@ -576,6 +3079,35 @@ int main(void) {
     check_linked_list_find_functionality();
 
     check_linked_list_additional_delete_tests();
+    check_linked_list_node_pool();
+    check_linked_list_indexed();
+    check_linked_list_find_and_count();
+    check_linked_list_finger();
+    check_linked_list_spans();
+    check_arena_list();
+    check_queue_chunk_boundaries();
+    check_queue_ring_buffer();
+    check_bulk_insertion();
+    check_bulk_removal();
+    check_queue_clear();
+    check_queue_inline();
+    check_deque();
+    check_allocator_contexts();
+    check_generic_containers();
+    check_splice();
+    check_linked_list_remove_if();
+    check_linked_list_sort();
+    check_spsc_queue();
+    check_mpmc_queue();
+    check_graph();
+    check_graph_cache();
+    check_graph_mtx_threads();
+    check_mmio_readers();
+    check_mmio_stream();
+
+#ifdef TEST_LINKED_LIST
+    linked_list_pool_destroy();
+#endif
 
     return 0;
 }
@@ -11,20 +11,50 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <limits.h>
 
 #include "mmio.h"
 
+/* Read buffer for files the readers open themselves. */
+#define MM_READ_BUFFER_SIZE (1 << 20)
+
+/* Opens fname for reading, with a MM_READ_BUFFER_SIZE buffer if one   */
+/* can be had. "stdin" names the standard input, which keeps its own   */
+/* buffer. *buffer must be passed on to mm_close_read().               */
+static FILE *mm_open_read(const char *fname, char **buffer)
+{
+    FILE *f;
+
+    *buffer = NULL;
+    if (strcmp(fname, "stdin") == 0)
+        return stdin;
+    if ((f = fopen(fname, "r")) == NULL)
+        return NULL;
+    *buffer = (char *) malloc(MM_READ_BUFFER_SIZE);
+    if (*buffer != NULL)
+        setvbuf(f, *buffer, _IOFBF, MM_READ_BUFFER_SIZE);
+    return f;
+}
+
+static void mm_close_read(FILE *f, char *buffer)
+{
+    if (f != stdin)
+        fclose(f);
+    free(buffer);
+}
+
 int mm_read_unsymmetric_sparse(const char *fname, int *M_, int *N_, int *nz_,
                 double **val_, int **I_, int **J_)
 {
     FILE *f;
+    char *buffer;
     MM_typecode matcode;
     int M, N, nz;
     int i;
     double *val;
     int *I, *J;
  
-    if ((f = fopen(fname, "r")) == NULL)
+    if ((f = mm_open_read(fname, &buffer)) == NULL)
             return -1;
  
  
@@ -32,6 +62,7 @@ int mm_read_unsymmetric_sparse(const char *fname, int *M_, int *N_, int *nz_,
     {
         printf("mm_read_unsymetric: Could not process Matrix Market banner ");
         printf(" in file [%s]\n", fname);
+        mm_close_read(f, buffer);
         return -1;
     }
  
@@ -43,6 +74,7 @@ int mm_read_unsymmetric_sparse(const char *fname, int *M_, int *N_, int *nz_,
         fprintf(stderr, "Sorry, this application does not support ");
         fprintf(stderr, "Market Market type: [%s]\n",
                 mm_typecode_to_str(matcode));
+        mm_close_read(f, buffer);
         return -1;
     }
  
@@ -51,6 +83,7 @@ int mm_read_unsymmetric_sparse(const char *fname, int *M_, int *N_, int *nz_,
     if (mm_read_mtx_crd_size(f, &M, &N, &nz) !=0)
     {
         fprintf(stderr, "read_unsymmetric_sparse(): could not parse matrix size.\n");
+        mm_close_read(f, buffer);
         return -1;
     }
  
@@ -64,21 +97,26 @@ int mm_read_unsymmetric_sparse(const char *fname, int *M_, int *N_, int *nz_,
     J = (int *) malloc(nz * sizeof(int));
     val = (double *) malloc(nz * sizeof(double));
  
-    *val_ = val;
-    *I_ = I;
-    *J_ = J;
- 
-    /* NOTE: when reading in doubles, ANSI C requires the use of the "l"  */
-    /*   specifier as in "%lg", "%lf", "%le", otherwise errors will occur */
-    /*  (ANSI C X3.159-1989, Sec. 4.9.6.2, p. 136 lines 13-15)            */
+    if (I == NULL || J == NULL || val == NULL ||
+        mm_read_mtx_crd_data(f, M, N, nz, I, J, val, matcode) != 0)
+    {
+        free(I);
+        free(J);
+        free(val);
+        mm_close_read(f, buffer);
+        return -1;
+    }
+    mm_close_read(f, buffer);
  
     for (i=0; i<nz; i++)
     {
-        fscanf(f, "%d %d %lg\n", &I[i], &J[i], &val[i]);
         I[i]--;  /* adjust from 1-based to 0-based */
         J[i]--;
     }
-    fclose(f);
+ 
+    *val_ = val;
+    *I_ = I;
+    *J_ = J;
  
     return 0;
 }
@@ -259,66 +297,306 @@ int mm_write_mtx_array_size(FILE *f, int M, int N)
 /*-------------------------------------------------------------------------*/
 
 /******************************************************************/
-/* use when I[], J[], and val[]J, and val[] are already allocated */
+/* Entry tokenizer used by the readers below in place of fscanf().  */
+/*                                                                  */
+/* fscanf() re-parses its format string, takes the stream lock and  */
+/* consults the locale on every call. These read the stream with    */
+/* getc_unlocked() while the caller holds the lock once for the     */
+/* whole loop, decode integers by hand and decode doubles with an   */
+/* exact fast path, falling back to strtod() for anything it can't  */
+/* do exactly. Like "%d" and "%lg" they skip leading white space    */
+/* and leave the character after the number in the stream.         */
 /******************************************************************/
 
-int mm_read_mtx_crd_data(FILE *f, int M, int N, int nz, int I[], int J[],
-        double val[], MM_typecode matcode)
+static int mm_is_blank(int c)
 {
-    int i;
-    if (mm_is_complex(matcode))
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+           c == '\f';
+}
+
+/* Skips white space; returns the first other character, or EOF. */
+static int mm_skip_blanks(FILE *f)
+{
+    int c;
+    do
+        c = getc_unlocked(f);
+    while (mm_is_blank(c));
+    return c;
+}
+
+/* Reads a decimal int with optional sign. Returns 1 on success, 0 if  */
+/* there is no number or it doesn't fit in an int.                     */
+static int mm_read_int(FILE *f, int *value)
+{
+    int c = mm_skip_blanks(f);
+    int negative = 0;
+    long long decoded = 0;
+    int digits = 0;
+
+    if (c == '-' || c == '+')
     {
-        for (i=0; i<nz; i++)
-            if (fscanf(f, "%d %d %lg %lg", &I[i], &J[i], &val[2*i], &val[2*i+1])
-                != 4) return MM_PREMATURE_EOF;
+        negative = c == '-';
+        c = getc_unlocked(f);
     }
-    else if (mm_is_real(matcode))
+    while ((unsigned) (c - '0') < 10)
     {
-        for (i=0; i<nz; i++)
+        if (decoded <= (long long) INT_MAX + 1)
+            decoded = decoded * 10 + (c - '0');
+        digits++;
+        c = getc_unlocked(f);
+    }
+    if (c != EOF)
+        ungetc(c, f);
+    if (negative)
+        decoded = -decoded;
+    if (digits == 0 || decoded > INT_MAX || decoded < INT_MIN)
+        return 0;
+    *value = (int) decoded;
+    return 1;
+}
+
+/* Decodes a whole token as a double. A token of at most 19 significant */
+/* digits, whose mantissa fits in the 53 bits of a double and whose    */
+/* decimal exponent is within 22, is one exact multiplication or       */
+/* division by a power of ten away, so correctly rounded; everything   */
+/* else, including inf, nan and hex floats, goes to strtod().          */
+static int mm_parse_double(const char *token, double *value)
+{
+    static const double powers_of_ten[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char *p = token;
+    int negative = 0;
+    unsigned long long mantissa = 0;
+    int significant = 0, digits = 0, exponent = 0;
+    char *end;
+
+    if (*p == '-' || *p == '+')
+        negative = *p++ == '-';
+    for (; (unsigned) (*p - '0') < 10; p++, digits++)
+    {
+        if (mantissa == 0 && *p == '0')
+            continue;
+        mantissa = mantissa * 10 + (unsigned) (*p - '0');
+        significant++;
+    }
+    if (*p == '.')
+    {
+        for (p++; (unsigned) (*p - '0') < 10; p++, digits++)
         {
-            if (fscanf(f, "%d %d %lg\n", &I[i], &J[i], &val[i])
-                != 3) return MM_PREMATURE_EOF;
+            exponent--;
+            if (mantissa == 0 && *p == '0')
+                continue;
+            mantissa = mantissa * 10 + (unsigned) (*p - '0');
+            significant++;
+        }
+    }
+    if (digits > 0 && (*p == 'e' || *p == 'E'))
+    {
+        int exponent_negative = 0, exponent_digits = 0, written = 0;
+        p++;
+        if (*p == '-' || *p == '+')
+            exponent_negative = *p++ == '-';
+        for (; (unsigned) (*p - '0') < 10; p++, exponent_digits++)
+            if (written < 10000)
+                written = written * 10 + (*p - '0');
+        if (exponent_digits == 0)
+            digits = 0;
+        exponent += exponent_negative ? -written : written;
+    }
 
+    if (digits > 0 && *p == '\0' && significant <= 19 &&
+        mantissa <= (1ULL << 53))
+    {
+        if (mantissa == 0)
+        {
+            *value = negative ? -0.0 : 0.0;
+            return 1;
+        }
+        if (exponent >= -22 && exponent <= 22)
+        {
+            double result = (double) mantissa;
+            result = exponent < 0 ? result / powers_of_ten[-exponent]
+                                  : result * powers_of_ten[exponent];
+            *value = negative ? -result : result;
+            return 1;
         }
     }
 
+    *value = strtod(token, &end);
+    return end != token && *end == '\0';
+}
+
+/* Reads a double, see mm_parse_double(). Returns 1 on success, 0 if   */
+/* the next token isn't a number.                                      */
+static int mm_read_double(FILE *f, double *value)
+{
+    char token[MM_MAX_LINE_LENGTH];
+    size_t length = 0;
+    int c = mm_skip_blanks(f);
+
+    while (c != EOF && !mm_is_blank(c))
+    {
+        if (length == sizeof(token) - 1)
+            return 0;
+        token[length++] = (char) c;
+        c = getc_unlocked(f);
+    }
+    if (c != EOF)
+        ungetc(c, f);
+    token[length] = '\0';
+    return length > 0 && mm_parse_double(token, value);
+}
+
+/* Reads one entry, without taking the stream lock. */
+static int mm_read_entry_unlocked(FILE *f, int *I, int *J, double *real,
+        double *imag, MM_typecode matcode)
+{
+    if (mm_is_complex(matcode))
+    {
+        if (!(mm_read_int(f, I) && mm_read_int(f, J) &&
+              mm_read_double(f, real) && mm_read_double(f, imag)))
+            return MM_PREMATURE_EOF;
+    }
+    else if (mm_is_real(matcode))
+    {
+        if (!(mm_read_int(f, I) && mm_read_int(f, J) &&
+              mm_read_double(f, real)))
+            return MM_PREMATURE_EOF;
+    }
     else if (mm_is_pattern(matcode))
     {
-        for (i=0; i<nz; i++)
-            if (fscanf(f, "%d %d", &I[i], &J[i])
-                != 2) return MM_PREMATURE_EOF;
+        if (!(mm_read_int(f, I) && mm_read_int(f, J)))
+            return MM_PREMATURE_EOF;
     }
     else
         return MM_UNSUPPORTED_TYPE;
 
     return 0;
+}
+
+/******************************************************************/
+/* use when I[], J[], and val[]J, and val[] are already allocated */
+/******************************************************************/
+
+int mm_read_mtx_crd_data(FILE *f, int M, int N, int nz, int I[], int J[],
+        double val[], MM_typecode matcode)
+{
+    int i;
+    int ret_code = 0;
+    double unused;
+
+    if (!(mm_is_complex(matcode) || mm_is_real(matcode) ||
+          mm_is_pattern(matcode)))
+        return MM_UNSUPPORTED_TYPE;
+
+    flockfile(f);
+    for (i=0; i<nz && ret_code == 0; i++)
+    {
+        if (mm_is_complex(matcode))
+            ret_code = mm_read_entry_unlocked(f, &I[i], &J[i], &val[2*i],
+                    &val[2*i+1], matcode);
+        else if (mm_is_real(matcode))
+            ret_code = mm_read_entry_unlocked(f, &I[i], &J[i], &val[i],
+                    &unused, matcode);
+        else
+            ret_code = mm_read_entry_unlocked(f, &I[i], &J[i], &unused,
+                    &unused, matcode);
+    }
+    funlockfile(f);
+
+    return ret_code;
         
 }
 
 int mm_read_mtx_crd_entry(FILE *f, int *I, int *J,
         double *real, double *imag, MM_typecode matcode)
 {
+    int ret_code;
+
+    flockfile(f);
+    ret_code = mm_read_entry_unlocked(f, I, J, real, imag, matcode);
+    funlockfile(f);
+
+    return ret_code;
+        
+}
+
+/******************************************************************/
+/* Reads the entries left in f in batches of up to batch_size and  */
+/* hands each batch to callback, so no more than one batch is ever */
+/* held in memory. Pattern matrices get no value storage at all.   */
+/******************************************************************/
+
+int mm_read_mtx_crd_stream(FILE *f, MM_typecode matcode,
+        mm_crd_callback callback, void *ctx, int batch_size)
+{
+    int *I, *J;
+    double *val = NULL;
+    int values, count = 0, ret_code = 0, c;
+
     if (mm_is_complex(matcode))
+        values = 2;
+    else if (mm_is_real(matcode) || mm_is_integer(matcode))
+        values = 1;
+    else if (mm_is_pattern(matcode))
+        values = 0;
+    else
+        return MM_UNSUPPORTED_TYPE;
+
+    if (batch_size <= 0)
+        batch_size = MM_STREAM_BATCH_SIZE;
+    I = (int *) malloc(batch_size * sizeof(int));
+    J = (int *) malloc(batch_size * sizeof(int));
+    if (values > 0)
+        val = (double *) malloc((size_t) batch_size * values * sizeof(double));
+    if (I == NULL || J == NULL || (values > 0 && val == NULL))
     {
-            if (fscanf(f, "%d %d %lg %lg", I, J, real, imag)
-                != 4) return MM_PREMATURE_EOF;
+        free(I);
+        free(J);
+        free(val);
+        return MM_OUT_OF_MEMORY;
     }
-    else if (mm_is_real(matcode))
-    {
-            if (fscanf(f, "%d %d %lg\n", I, J, real)
-                != 3) return MM_PREMATURE_EOF;
 
+    flockfile(f);
+    for (;;)
+    {
+        /* running out of input between entries is the normal way out */
+        c = mm_skip_blanks(f);
+        if (c == EOF)
+            break;
+        ungetc(c, f);
+
+        if (!(mm_read_int(f, &I[count]) && mm_read_int(f, &J[count]) &&
+              (values < 1 || mm_read_double(f, &val[values*count])) &&
+              (values < 2 || mm_read_double(f, &val[values*count+1]))))
+        {
+            ret_code = MM_PREMATURE_EOF;
+            break;
+        }
+        if (++count == batch_size)
+        {
+            ret_code = callback(ctx, count, I, J, val);
+            count = 0;
+            if (ret_code != 0)
+                break;
+        }
     }
+    funlockfile(f);
 
-    else if (mm_is_pattern(matcode))
+    /* the complete entries before a bad one are still delivered */
+    if (count > 0)
     {
-            if (fscanf(f, "%d %d", I, J) != 2) return MM_PREMATURE_EOF;
+        int flushed = callback(ctx, count, I, J, val);
+        if (ret_code == 0)
+            ret_code = flushed;
     }
-    else
-        return MM_UNSUPPORTED_TYPE;
 
-    return 0;
-        
+    free(I);
+    free(J);
+    free(val);
+    return ret_code;
 }
 
 
@@ -335,22 +613,30 @@ int mm_read_mtx_crd(char *fname, int *M, int *N, int *nz, int **I, int **J,
 {
     int ret_code;
     FILE *f;
+    char *buffer;
 
-    if (strcmp(fname, "stdin") == 0) f=stdin;
-    else
-    if ((f = fopen(fname, "r")) == NULL)
+    if ((f = mm_open_read(fname, &buffer)) == NULL)
         return MM_COULD_NOT_READ_FILE;
 
 
     if ((ret_code = mm_read_banner(f, matcode)) != 0)
+    {
+        mm_close_read(f, buffer);
         return ret_code;
+    }
 
     if (!(mm_is_valid(*matcode) && mm_is_sparse(*matcode) && 
             mm_is_matrix(*matcode)))
+    {
+        mm_close_read(f, buffer);
         return MM_UNSUPPORTED_TYPE;
+    }
 
     if ((ret_code = mm_read_mtx_crd_size(f, M, N, nz)) != 0)
+    {
+        mm_close_read(f, buffer);
         return ret_code;
+    }
 
 
     *I = (int *)  malloc(*nz * sizeof(int));
@@ -362,25 +648,22 @@ int mm_read_mtx_crd(char *fname, int *M, int *N, int *nz, int **I, int **J,
         *val = (double *) malloc(*nz * 2 * sizeof(double));
         ret_code = mm_read_mtx_crd_data(f, *M, *N, *nz, *I, *J, *val, 
                 *matcode);
-        if (ret_code != 0) return ret_code;
     }
     else if (mm_is_real(*matcode))
     {
         *val = (double *) malloc(*nz * sizeof(double));
         ret_code = mm_read_mtx_crd_data(f, *M, *N, *nz, *I, *J, *val, 
                 *matcode);
-        if (ret_code != 0) return ret_code;
     }
 
     else if (mm_is_pattern(*matcode))
     {
         ret_code = mm_read_mtx_crd_data(f, *M, *N, *nz, *I, *J, *val, 
                 *matcode);
-        if (ret_code != 0) return ret_code;
     }
 
-    if (f != stdin) fclose(f);
-    return 0;
+    mm_close_read(f, buffer);
+    return ret_code;
 }
 
 int mm_write_banner(FILE *f, MM_typecode matcode)
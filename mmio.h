@@ -83,6 +83,7 @@ int mm_is_valid(MM_typecode matcode);		/* too complex for a macro */
 #define MM_UNSUPPORTED_TYPE		15
 #define MM_LINE_TOO_LONG		16
 #define MM_COULD_NOT_WRITE_FILE	17
+#define MM_OUT_OF_MEMORY		18
 
 
 /******************** Matrix Market internal definitions ********************
@@ -125,6 +126,31 @@ int mm_read_mtx_crd_data(FILE *f, int M, int N, int nz, int I[], int J[],
 int mm_read_mtx_crd_entry(FILE *f, int *I, int *J, double *real, double *img,
 					MM_typecode matcode);
 
+/*  streaming reader: entries are handed to a callback in batches instead */
+/*  of being collected into nz-sized arrays                               */
+
+#define MM_STREAM_BATCH_SIZE 4096
+
+/*  Gets the next count entries (I[k], J[k]) of the file, 1-based as      */
+/*  written. val is NULL for pattern matrices, holds count values for     */
+/*  real and integer ones and count (real, imaginary) pairs for complex   */
+/*  ones; the arrays are reused for the next batch. Returns 0 to go on    */
+/*  reading, anything else to stop, which mm_read_mtx_crd_stream() then   */
+/*  returns.                                                              */
+typedef int (*mm_crd_callback)(void *ctx, int count, const int I[],
+				const int J[], const double val[]);
+
+/*  Reads the entries from the current position of f, usually right after */
+/*  mm_read_mtx_crd_size(), to the end of the file, in batches of at most */
+/*  batch_size entries (MM_STREAM_BATCH_SIZE if batch_size <= 0). Returns */
+/*  0 at the end of the file, the callback's value if it stopped early,   */
+/*  MM_PREMATURE_EOF on a malformed or cut off entry (the entries before  */
+/*  it are delivered first), MM_UNSUPPORTED_TYPE or MM_OUT_OF_MEMORY.     */
+/*  The number of entries isn't checked against nz; count them in the     */
+/*  callback to do that.                                                  */
+int mm_read_mtx_crd_stream(FILE *f, MM_typecode matcode,
+				mm_crd_callback callback, void *ctx, int batch_size);
+
 int mm_read_unsymmetric_sparse(const char *fname, int *M_, int *N_, int *nz_,
 		                double **val_, int **I_, int **J_);
 
@@ -0,0 +1,410 @@
+/*
+*MIT License
+*
+*Copyright (c) 2025 Siddhant Nadkarni
+*
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*/
+
+
+
+#include "mpmc_queue.h"
+
+// Function pointers to (potentially) custom malloc() and
+// free() functions.
+//
+static void * (*malloc_fptr)(size_t size) = NULL;
+static void   (*free_fptr)(void* addr)    = NULL;
+
+// Index of the hazard record this thread tried first last time. Spreads
+// threads over the records so they rarely collide on claiming one.
+//
+static _Thread_local size_t hazard_hint = SIZE_MAX;
+static _Atomic size_t next_hazard_hint  = 0;
+
+// Allocates memory aligned to a cache line with malloc_fptr(), which
+// makes no alignment promises of its own.
+// \param size       : Number of bytes needed.
+// \param allocation : Where to store the pointer to hand to free_fptr().
+// Returns aligned memory on success, NULL on failure.
+//
+static void * mpmc_aligned_alloc(size_t size, void ** allocation){
+    void * raw = malloc_fptr(size + MPMC_QUEUE_CACHE_LINE - 1);
+    if(raw == NULL){
+        return NULL;
+    }
+    *allocation = raw;
+    return (void *)(((uintptr_t)raw + MPMC_QUEUE_CACHE_LINE - 1) &
+                    ~(uintptr_t)(MPMC_QUEUE_CACHE_LINE - 1));
+}
+
+// Allocates an empty segment.
+// Returns a segment on success, NULL on failure.
+//
+static struct mpmc_segment * mpmc_segment_create(void){
+    void * allocation = NULL;
+    struct mpmc_segment * segment = mpmc_aligned_alloc(sizeof(struct mpmc_segment), &allocation);
+    if(segment == NULL){
+        return NULL;
+    }
+
+    atomic_init(&segment->deq_index, 0);
+    atomic_init(&segment->enq_index, 0);
+    atomic_init(&segment->next, NULL);
+    for(size_t i = 0; i < MPMC_QUEUE_SEGMENT_SIZE; i++){
+        atomic_init(&segment->slots[i], 0);
+    }
+    segment->retired_next = NULL;
+    segment->allocation   = allocation;
+
+    return segment;
+}
+
+// Claims a free hazard record for the calling thread, spinning if all
+// MPMC_QUEUE_MAX_THREADS records are in use.
+// \param queue : Pointer to mpmc_queue.
+// Returns the claimed record.
+//
+static struct mpmc_hazard * mpmc_hazard_acquire(struct mpmc_queue * queue){
+    if(hazard_hint == SIZE_MAX){
+        hazard_hint = atomic_fetch_add_explicit(&next_hazard_hint, 1, memory_order_relaxed) %
+                      MPMC_QUEUE_MAX_THREADS;
+    }
+
+    size_t i = hazard_hint;
+    for(;;){
+        struct mpmc_hazard * hazard = &queue->hazards[i];
+        if(!atomic_load_explicit(&hazard->in_use, memory_order_relaxed) &&
+           !atomic_exchange_explicit(&hazard->in_use, true, memory_order_acquire)){
+            hazard_hint = i;
+            return hazard;
+        }
+        i = (i + 1) % MPMC_QUEUE_MAX_THREADS;
+    }
+}
+
+// Clears and gives back a hazard record.
+// \param hazard : Record claimed by mpmc_hazard_acquire().
+//
+static void mpmc_hazard_release(struct mpmc_hazard * hazard){
+    atomic_store(&hazard->pointer, NULL);
+    atomic_store_explicit(&hazard->in_use, false, memory_order_release);
+}
+
+// Reads a segment pointer and publishes it as hazardous, re-reading
+// until the published value is still current. Once this returns, the
+// segment can't be freed until the hazard is cleared.
+// \param hazard : Record owned by the calling thread.
+// \param source : Shared pointer to read (queue->head or queue->tail).
+// Returns the protected segment.
+//
+static struct mpmc_segment * mpmc_hazard_protect(struct mpmc_hazard * hazard,
+                                                 _Atomic(struct mpmc_segment *) * source){
+    struct mpmc_segment * segment = atomic_load(source);
+    for(;;){
+        atomic_store(&hazard->pointer, segment);
+        struct mpmc_segment * current = atomic_load(source);
+        if(current == segment){
+            return segment;
+        }
+        segment = current;
+    }
+}
+
+// Pushes a segment onto the retired stack.
+// \param queue   : Pointer to mpmc_queue.
+// \param segment : Segment to push.
+//
+static void mpmc_retired_push(struct mpmc_queue * queue, struct mpmc_segment * segment){
+    struct mpmc_segment * top = atomic_load(&queue->retired);
+    do{
+        segment->retired_next = top;
+    }while(!atomic_compare_exchange_weak(&queue->retired, &top, segment));
+}
+
+// Frees every retired segment that no hazard pointer refers to. The
+// rest go back on the retired stack for a later pass.
+// \param queue : Pointer to mpmc_queue.
+//
+static void mpmc_reclaim(struct mpmc_queue * queue){
+    struct mpmc_segment * list = atomic_exchange(&queue->retired, NULL);
+
+    //snapshot the hazard pointers once rather than per segment
+    struct mpmc_segment * protected[MPMC_QUEUE_MAX_THREADS];
+    for(size_t i = 0; i < MPMC_QUEUE_MAX_THREADS; i++){
+        protected[i] = atomic_load(&queue->hazards[i].pointer);
+    }
+
+    size_t freed = 0;
+    while(list != NULL){
+        struct mpmc_segment * next = list->retired_next;
+        bool in_use = false;
+        for(size_t i = 0; i < MPMC_QUEUE_MAX_THREADS && !in_use; i++){
+            in_use = (protected[i] == list);
+        }
+        if(in_use){
+            mpmc_retired_push(queue, list);
+        }
+        else{
+            free_fptr(list->allocation);
+            freed++;
+        }
+        list = next;
+    }
+    atomic_fetch_sub(&queue->retired_count, freed);
+}
+
+// Retires a segment that head has moved past.
+// \param queue   : Pointer to mpmc_queue.
+// \param segment : Segment no longer reachable from head.
+//
+static void mpmc_retire(struct mpmc_queue * queue, struct mpmc_segment * segment){
+    mpmc_retired_push(queue, segment);
+    if(atomic_fetch_add(&queue->retired_count, 1) + 1 >= MPMC_QUEUE_RETIRE_THRESHOLD){
+        mpmc_reclaim(queue);
+    }
+}
+
+// Creates a new mpmc_queue.
+// Returns a new mpmc_queue on success, NULL on failure.
+//
+struct mpmc_queue * mpmc_queue_create(void){
+    //check if malloc_fptr/free_fptr are NULL
+    if(malloc_fptr == NULL || free_fptr == NULL){
+        return NULL;
+    }
+
+    void * allocation = NULL;
+    struct mpmc_queue * queue = mpmc_aligned_alloc(sizeof(struct mpmc_queue), &allocation);
+    if(queue == NULL){
+        return NULL;
+    }
+
+    //start with one empty segment that is both head and tail
+    struct mpmc_segment * segment = mpmc_segment_create();
+    if(segment == NULL){
+        free_fptr(allocation);
+        return NULL;
+    }
+
+    atomic_init(&queue->head, segment);
+    atomic_init(&queue->tail, segment);
+    atomic_init(&queue->retired, NULL);
+    atomic_init(&queue->retired_count, 0);
+    queue->allocation = allocation;
+    for(size_t i = 0; i < MPMC_QUEUE_MAX_THREADS; i++){
+        atomic_init(&queue->hazards[i].pointer, NULL);
+        atomic_init(&queue->hazards[i].in_use, false);
+    }
+
+    return queue;
+}
+
+// Deletes a mpmc_queue.
+// \param queue : Pointer to mpmc_queue to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool mpmc_queue_delete(struct mpmc_queue * queue){
+    //check if input is NULL and free_fptr is NULL
+    if(queue == NULL || free_fptr == NULL){
+        return false;
+    }
+
+    //free the live segments, then anything still waiting on reclamation
+    struct mpmc_segment * segment = atomic_load(&queue->head);
+    while(segment != NULL){
+        struct mpmc_segment * next = atomic_load(&segment->next);
+        free_fptr(segment->allocation);
+        segment = next;
+    }
+    segment = atomic_load(&queue->retired);
+    while(segment != NULL){
+        struct mpmc_segment * next = segment->retired_next;
+        free_fptr(segment->allocation);
+        segment = next;
+    }
+
+    free_fptr(queue->allocation);
+
+    return true;
+}
+
+// Pushes an unsigned int onto the queue.
+// \param queue : Pointer to mpmc_queue.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool mpmc_queue_push(struct mpmc_queue * queue, unsigned int data){
+    if(queue == NULL){
+        return false;
+    }
+
+    struct mpmc_hazard * hazard = mpmc_hazard_acquire(queue);
+    bool success = true;
+
+    for(;;){
+        struct mpmc_segment * tail = mpmc_hazard_protect(hazard, &queue->tail);
+
+        //claim a slot, and fill it unless a consumer already gave up on it
+        size_t index = atomic_fetch_add(&tail->enq_index, 1);
+        if(index < MPMC_QUEUE_SEGMENT_SIZE){
+            uint64_t expected = 0;
+            if(atomic_compare_exchange_strong(&tail->slots[index], &expected, (uint64_t)data + 1)){
+                break;
+            }
+            continue;
+        }
+
+        //segment is full, help move tail along or append a new segment
+        if(tail != atomic_load(&queue->tail)){
+            continue;
+        }
+        struct mpmc_segment * next = atomic_load(&tail->next);
+        if(next != NULL){
+            atomic_compare_exchange_strong(&queue->tail, &tail, next);
+            continue;
+        }
+
+        struct mpmc_segment * segment = mpmc_segment_create();
+        if(segment == NULL){
+            success = false;
+            break;
+        }
+        //the new segment starts out holding this entry
+        atomic_init(&segment->slots[0], (uint64_t)data + 1);
+        atomic_init(&segment->enq_index, 1);
+
+        struct mpmc_segment * expected_next = NULL;
+        if(atomic_compare_exchange_strong(&tail->next, &expected_next, segment)){
+            atomic_compare_exchange_strong(&queue->tail, &tail, segment);
+            break;
+        }
+        //another producer appended first, the segment was never shared
+        free_fptr(segment->allocation);
+    }
+
+    mpmc_hazard_release(hazard);
+    return success;
+}
+
+// Pops an unsigned int from the queue, if one exists.
+// \param queue       : Pointer to mpmc_queue.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE if the queue was empty.
+//
+bool mpmc_queue_pop(struct mpmc_queue * queue, unsigned int * popped_data){
+    if(queue == NULL || popped_data == NULL){
+        return false;
+    }
+
+    struct mpmc_hazard * hazard = mpmc_hazard_acquire(queue);
+    bool success = false;
+
+    for(;;){
+        struct mpmc_segment * head = mpmc_hazard_protect(hazard, &queue->head);
+
+        //nothing left in this segment and nothing after it
+        if(atomic_load(&head->deq_index) >= atomic_load(&head->enq_index) &&
+           atomic_load(&head->next) == NULL){
+            break;
+        }
+
+        size_t index = atomic_fetch_add(&head->deq_index, 1);
+        if(index >= MPMC_QUEUE_SEGMENT_SIZE){
+            //segment drained, move head on to the next one
+            struct mpmc_segment * next = atomic_load(&head->next);
+            if(next == NULL){
+                break;
+            }
+
+            //never let head overtake tail, or a producer could still
+            //be handed the segment after it has been freed
+            struct mpmc_segment * tail = head;
+            atomic_compare_exchange_strong(&queue->tail, &tail, next);
+
+            struct mpmc_segment * expected = head;
+            if(atomic_compare_exchange_strong(&queue->head, &expected, next)){
+                atomic_store(&hazard->pointer, NULL);
+                mpmc_retire(queue, head);
+            }
+            continue;
+        }
+
+        //take the slot; 0 means its producer hasn't written it yet and
+        //will have to go find another slot
+        uint64_t item = atomic_exchange(&head->slots[index], MPMC_QUEUE_SLOT_TAKEN);
+        if(item != 0){
+            *popped_data = (unsigned int)(item - 1);
+            success = true;
+            break;
+        }
+    }
+
+    mpmc_hazard_release(hazard);
+    return success;
+}
+
+// Returns whether an entry exists to be popped.
+// \param queue : Pointer to mpmc_queue.
+// Returns TRUE if an entry can be popped, FALSE otherwise.
+//
+bool mpmc_queue_has_next(struct mpmc_queue * queue){
+    if(queue == NULL){
+        return false;
+    }
+
+    struct mpmc_hazard * hazard = mpmc_hazard_acquire(queue);
+    struct mpmc_segment * head = mpmc_hazard_protect(hazard, &queue->head);
+
+    size_t deq_index = atomic_load(&head->deq_index);
+    bool has_next = (deq_index < atomic_load(&head->enq_index) &&
+                     deq_index < MPMC_QUEUE_SEGMENT_SIZE) ||
+                    atomic_load(&head->next) != NULL;
+
+    mpmc_hazard_release(hazard);
+    return has_next;
+}
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool mpmc_queue_register_malloc(void * (*malloc)(size_t)){
+    //exit if input is NULL
+    if(malloc == NULL){
+        return false;
+    }
+
+    malloc_fptr = malloc;
+    return true;
+}
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool mpmc_queue_register_free(void (*free)(void*)){
+    //exit if input is NULL
+    if(free == NULL){
+        return false;
+    }
+
+    free_fptr = free;
+    return true;
+}
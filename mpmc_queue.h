@@ -0,0 +1,122 @@
+#ifndef _MPMC_QUEUE_H
+#define _MPMC_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Size of a cache line, used to keep independently written fields
+// from false sharing.
+//
+#define MPMC_QUEUE_CACHE_LINE 64
+
+// Number of slots in a segment. A segment is a little over 8 KiB.
+//
+#define MPMC_QUEUE_SEGMENT_SIZE 1024
+
+// Maximum number of threads that can be inside a push or pop on the
+// same queue at once. Each one needs a hazard pointer record; a thread
+// that finds them all busy spins until one frees up.
+//
+#define MPMC_QUEUE_MAX_THREADS 128
+
+// Number of retired segments that triggers a reclamation pass.
+//
+#define MPMC_QUEUE_RETIRE_THRESHOLD 32
+
+// A fixed size array of slots. Producers claim slots with a
+// fetch-and-add on enq_index and consumers with a fetch-and-add on
+// deq_index, so threads only contend on a CAS when a producer and a
+// consumer race for the very same slot. Segments are chained through
+// next as the queue grows.
+//
+// A slot holds 0 while empty, data + 1 once a producer has filled it,
+// and MPMC_QUEUE_SLOT_TAKEN once a consumer has claimed it.
+//
+#define MPMC_QUEUE_SLOT_TAKEN UINT64_MAX
+
+struct mpmc_segment {
+    _Alignas(MPMC_QUEUE_CACHE_LINE) _Atomic size_t deq_index;
+    _Alignas(MPMC_QUEUE_CACHE_LINE) _Atomic size_t enq_index;
+    _Alignas(MPMC_QUEUE_CACHE_LINE) _Atomic(struct mpmc_segment *) next;
+    struct mpmc_segment * retired_next;
+    void * allocation;
+    _Alignas(MPMC_QUEUE_CACHE_LINE) _Atomic uint64_t slots[MPMC_QUEUE_SEGMENT_SIZE];
+};
+
+// A hazard pointer record. A thread inside a push or pop owns one
+// record and publishes the segment it is about to dereference in
+// pointer, which stops that segment from being freed under it.
+//
+struct mpmc_hazard {
+    _Alignas(MPMC_QUEUE_CACHE_LINE) _Atomic(struct mpmc_segment *) pointer;
+    atomic_bool in_use;
+};
+
+// Lock-free multi-producer/multi-consumer FIFO of unsigned ints, based
+// on a linked list of fetch-and-add indexed segments. Segments that
+// consumers have moved past are retired and freed once no hazard
+// pointer refers to them.
+//
+struct mpmc_queue {
+    _Alignas(MPMC_QUEUE_CACHE_LINE) _Atomic(struct mpmc_segment *) head;
+    _Alignas(MPMC_QUEUE_CACHE_LINE) _Atomic(struct mpmc_segment *) tail;
+    _Alignas(MPMC_QUEUE_CACHE_LINE) _Atomic(struct mpmc_segment *) retired;
+    _Atomic size_t retired_count;
+    void * allocation;
+    struct mpmc_hazard hazards[MPMC_QUEUE_MAX_THREADS];
+};
+
+// Creates a new mpmc_queue.
+// PRECONDITION: Register malloc() and free() functions via the
+//               mpmc_queue_register_malloc() and
+//               mpmc_queue_register_free() functions. Both must be
+//               safe to call from any thread that uses the queue.
+// Returns a new mpmc_queue on success, NULL on failure.
+//
+struct mpmc_queue * mpmc_queue_create(void);
+
+// Deletes a mpmc_queue.
+// PRECONDITION: No other thread is still using the queue.
+// \param queue : Pointer to mpmc_queue to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool mpmc_queue_delete(struct mpmc_queue * queue);
+
+// Pushes an unsigned int onto the queue. Safe to call from any number
+// of threads concurrently.
+// \param queue : Pointer to mpmc_queue.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool mpmc_queue_push(struct mpmc_queue * queue, unsigned int data);
+
+// Pops an unsigned int from the queue, if one exists. Safe to call
+// from any number of threads concurrently. Never blocks.
+// \param queue       : Pointer to mpmc_queue.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE if the queue was empty.
+//
+bool mpmc_queue_pop(struct mpmc_queue * queue, unsigned int * popped_data);
+
+// Returns whether an entry exists to be popped. Only a snapshot while
+// other threads are pushing or popping.
+// \param queue : Pointer to mpmc_queue.
+// Returns TRUE if an entry can be popped, FALSE otherwise.
+//
+bool mpmc_queue_has_next(struct mpmc_queue * queue);
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool mpmc_queue_register_malloc(void * (*malloc)(size_t));
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool mpmc_queue_register_free(void (*free)(void*));
+
+#endif
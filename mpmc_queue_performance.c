@@ -0,0 +1,179 @@
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mpmc_queue.h"
+
+// Scaling benchmark for the multi-producer/multi-consumer queue. Every
+// thread runs push/pop pairs against one shared queue, the standard
+// "enqueue-dequeue pairs" workload, at 1, 2, 4, 8 and N threads, where
+// N is the number of online CPUs. Usage:
+//
+//     ./mpmc_queue_performance [pairs]
+//
+// pairs is the total number of push/pop pairs per thread count, split
+// evenly across the threads.
+//
+#define GRAB_CLOCK(x) clock_gettime(CLOCK_MONOTONIC, &x);
+#define DEFAULT_PAIRS 10000000UL
+#define MAX_CONFIGURATIONS 5
+
+// Number of failed pops before a spinning thread gives up its time
+// slice. Keeps oversubscribed runs from crawling.
+//
+#define SPINS_BEFORE_YIELD 1024
+
+struct worker {
+    pthread_t thread;
+    size_t id;
+    size_t pairs;
+    uint64_t pushed_sum;
+    uint64_t popped_sum;
+};
+
+struct mpmc_queue * queue = NULL;
+pthread_barrier_t start_barrier;
+long online_cpus = 1;
+
+long compute_timespec_diff(struct timespec start,
+                           struct timespec stop) {
+    return (stop.tv_sec - start.tv_sec) * 1000000000L +
+           (stop.tv_nsec - start.tv_nsec);
+}
+
+void * worker_main(void * arg) {
+    struct worker * worker = (struct worker *)arg;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(worker->id % online_cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+    pthread_barrier_wait(&start_barrier);
+
+    for (size_t i = 0; i < worker->pairs; i++) {
+        unsigned int data = (unsigned int)(worker->id * worker->pairs + i);
+        if (!mpmc_queue_push(queue, data)) {
+            printf("Error pushing into queue.\n");
+            exit(1);
+        }
+        worker->pushed_sum += data;
+
+        // Every thread pushes before it pops, so the queue is never
+        // truly empty here; a failed pop only means the entry we're
+        // racing for is still in flight.
+        //
+        unsigned int spins = 0;
+        while (!mpmc_queue_pop(queue, &data)) {
+            if (++spins == SPINS_BEFORE_YIELD) {
+                spins = 0;
+                sched_yield();
+            }
+        }
+        worker->popped_sum += data;
+    }
+
+    return NULL;
+}
+
+// Runs the benchmark with a given number of threads.
+// Returns throughput in operations (pushes + pops) per second.
+//
+double run(size_t threads, size_t pairs) {
+    struct worker * workers = calloc(threads, sizeof(struct worker));
+    if (workers == NULL) {
+        printf("Failed to allocate workers.\n");
+        exit(1);
+    }
+
+    pthread_barrier_init(&start_barrier, NULL, threads + 1);
+    for (size_t i = 0; i < threads; i++) {
+        workers[i].id    = i;
+        workers[i].pairs = pairs / threads;
+        if (pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]) != 0) {
+            printf("Failed to create thread.\n");
+            exit(1);
+        }
+    }
+
+    struct timespec start, stop;
+    pthread_barrier_wait(&start_barrier);
+    GRAB_CLOCK(start)
+    for (size_t i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    GRAB_CLOCK(stop)
+    pthread_barrier_destroy(&start_barrier);
+
+    // Everything pushed must have been popped exactly once.
+    //
+    uint64_t pushed_sum = 0;
+    uint64_t popped_sum = 0;
+    for (size_t i = 0; i < threads; i++) {
+        pushed_sum += workers[i].pushed_sum;
+        popped_sum += workers[i].popped_sum;
+    }
+    if (pushed_sum != popped_sum || mpmc_queue_has_next(queue)) {
+        printf("Pushed and popped data do not match.\n");
+        exit(1);
+    }
+
+    long nanoseconds = compute_timespec_diff(start, stop);
+    double operations = 2.0 * (double)(threads * (pairs / threads));
+    free(workers);
+
+    return operations / ((double)nanoseconds / 1000000000.0);
+}
+
+int main(int argc, char ** argv) {
+    size_t pairs = DEFAULT_PAIRS;
+    if (argc > 1) {
+        pairs = strtoul(argv[1], NULL, 10);
+    }
+
+    mpmc_queue_register_malloc(malloc);
+    mpmc_queue_register_free(free);
+
+    online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online_cpus < 1) {
+        online_cpus = 1;
+    }
+
+    queue = mpmc_queue_create();
+    if (queue == NULL) {
+        printf("Failed to create mpmc_queue.\n");
+        return 1;
+    }
+
+    // 1, 2, 4, 8 and N threads, skipping N if it's already in the list.
+    //
+    size_t configurations[MAX_CONFIGURATIONS] = { 1, 2, 4, 8, (size_t)online_cpus };
+    size_t configuration_count = MAX_CONFIGURATIONS;
+    for (size_t i = 0; i < MAX_CONFIGURATIONS - 1; i++) {
+        if (configurations[i] == (size_t)online_cpus) {
+            configuration_count = MAX_CONFIGURATIONS - 1;
+        }
+    }
+
+    printf("Push/pop pairs per run: %zu, online CPUs: %ld\n", pairs, online_cpus);
+    double single_thread = 0.0;
+    for (size_t i = 0; i < configuration_count; i++) {
+        double throughput = run(configurations[i], pairs);
+        if (i == 0) {
+            single_thread = throughput;
+        }
+        printf("Threads: %3zu throughput [Mops/s]: %8.2f scaling: %0.2fx\n",
+               configurations[i], throughput / 1000000.0, throughput / single_thread);
+    }
+
+    mpmc_queue_delete(queue);
+
+    return 0;
+}
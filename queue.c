@@ -23,6 +23,8 @@
 */
 
 
+#include <string.h>
+
 #include "queue.h"
 
 // Function pointers to (potentially) custom malloc() and
@@ -31,8 +33,206 @@
 static void * (*malloc_fptr)(size_t size) = NULL;
 static void   (*free_fptr)(void* addr)    = NULL;
 
-// Implement your queue functions here.
+// Default allocator context, forwarding to the registered functions.
+//
+static void * default_alloc(void * state, size_t size){
+    (void)state;
+    return malloc_fptr(size);
+}
+
+static void default_free(void * state, void * addr){
+    (void)state;
+    free_fptr(addr);
+}
+
+static const struct allocator default_allocator = { default_alloc, default_free, NULL };
+
+// Allocates size bytes through the queue's allocator context.
+//
+static void * queue_malloc(struct queue * queue, size_t size){
+    return queue->allocator.alloc(queue->allocator.state, size);
+}
+
+// Frees memory through the queue's allocator context.
+//
+static void queue_free(struct queue * queue, void * addr){
+    queue->allocator.free(queue->allocator.state, addr);
+}
+
+// Returns the number of drained chunks a chunked queue may keep,
+// derived from its high water mark. Always at least one.
+// \param queue : Pointer to queue.
+//
+static size_t queue_spare_limit(struct queue * queue){
+    size_t limit = queue->high_water_mark / QUEUE_CHUNK_CAPACITY;
+    return limit > 0 ? limit : 1;
+}
+
+// Grabs an empty chunk, preferring a spare chunk over a fresh
+// allocation.
+// \param queue : Pointer to queue.
+// Returns a chunk on success, NULL on allocation failure.
+//
+static struct queue_chunk * queue_chunk_acquire(struct queue * queue){
+    struct queue_chunk * chunk = queue->spare;
+    if(chunk != NULL){
+        queue->spare = chunk->next;
+        queue->spare_count--;
+    }
+    else{
+        chunk = (struct queue_chunk *)queue_malloc(queue, sizeof(struct queue_chunk));
+        if(chunk == NULL){
+            return NULL;
+        }
+    }
+
+    chunk->next = NULL;
+    chunk->end  = QUEUE_CHUNK_CAPACITY;
+    return chunk;
+}
+
+// Gives a drained chunk back, keeping it on the spare list unless
+// the list is already at its limit.
+// \param queue : Pointer to queue.
+// \param chunk : Chunk that no longer holds any live entries.
+//
+static void queue_chunk_release(struct queue * queue, struct queue_chunk * chunk){
+    if(queue->spare_count < queue_spare_limit(queue)){
+        chunk->next  = queue->spare;
+        queue->spare = chunk;
+        queue->spare_count++;
+    }
+    else{
+        queue_free(queue, chunk);
+    }
+}
+
+// Frees spare chunks until the spare list is within its limit.
+// \param queue : Pointer to queue.
+//
+static void queue_chunk_trim(struct queue * queue){
+    size_t limit = queue_spare_limit(queue);
+    while(queue->spare_count > limit){
+        struct queue_chunk * chunk = queue->spare;
+        queue->spare = chunk->next;
+        queue->spare_count--;
+        queue_free(queue, chunk);
+    }
+}
+
+// Fixes up a chunked queue after entries were consumed from the head
+// chunk: a fully consumed head chunk is released and the next one
+// becomes the head, and a queue drained part way through its only
+// chunk is rewound so that chunk gets reused from the start.
+// \param queue : Pointer to a QUEUE_STORAGE_CHUNKED queue.
+//
+static void queue_chunk_settle(struct queue * queue){
+    if(queue->head_index == queue->head_end){
+        //head chunk fully consumed, move on to the next one
+        struct queue_chunk * drained = queue->head;
+        queue->head       = drained->next;
+        queue->head_index = 0;
+        queue_chunk_release(queue, drained);
+
+        //that was the last chunk, go back to the "no chunks" state
+        if(queue->head == NULL){
+            queue->tail       = NULL;
+            queue->head_index = QUEUE_CHUNK_CAPACITY;
+            queue->tail_index = QUEUE_CHUNK_CAPACITY;
+            queue->head_end   = QUEUE_CHUNK_CAPACITY;
+        }
+        else{
+            queue->head_end = queue->head->end;
+        }
+    }
+    else if(queue->size == 0){
+        //queue drained mid-chunk, rewind so the chunk is reused from the start
+        queue->head_index = 0;
+        queue->tail_index = 0;
+    }
+}
+
+// Grows a ring buffer queue so it can hold at least `needed` entries.
+// The capacity is doubled until it fits, and the live entries are
+// unwrapped to the start of the new buffer, which takes at most two
+// memcpy() calls: one for ring_head up to the end of the old buffer,
+// and one for the part that wrapped around to its start.
+// \param queue  : Pointer to a QUEUE_STORAGE_RING queue.
+// \param needed : Number of entries the buffer must be able to hold.
+// Returns TRUE on success, FALSE otherwise. The queue is unchanged on failure.
+//
+static bool queue_ring_reserve(struct queue * queue, size_t needed){
+    size_t old_capacity = queue->ring_mask + 1;
+    size_t capacity     = old_capacity;
+    while(capacity < needed){
+        if(capacity > SIZE_MAX / (2 * sizeof(unsigned int))){
+            return false;
+        }
+        capacity *= 2;
+    }
+    if(capacity == old_capacity){
+        return true;
+    }
+
+    unsigned int * ring = (unsigned int *)queue_malloc(queue, capacity * sizeof(unsigned int));
+    if(ring == NULL){
+        return false;
+    }
+
+    //entries from ring_head up to the end of the old buffer
+    size_t first = old_capacity - queue->ring_head;
+    if(first > queue->size){
+        first = queue->size;
+    }
+    memcpy(ring, queue->ring + queue->ring_head, first * sizeof(unsigned int));
+    //entries that wrapped around to the start of the old buffer
+    memcpy(ring + first, queue->ring, (queue->size - first) * sizeof(unsigned int));
+
+    queue_free(queue, queue->ring);
+    queue->ring      = ring;
+    queue->ring_mask = capacity - 1;
+    queue->ring_head = 0;
+
+    return true;
+}
+
+// Allocates a queue and sets it up as an empty chunked queue.
+// \param allocator : Allocator context for the queue and its storage.
+// Returns a new queue on success, NULL on failure.
 //
+static struct queue * queue_alloc(const struct allocator * allocator){
+    //the default context needs both functions registered
+    if(allocator == &default_allocator && (malloc_fptr == NULL || free_fptr == NULL)){
+        return NULL;
+    }
+    //allocate queue
+    struct queue *queue = (struct queue *)allocator->alloc(allocator->state, sizeof(struct queue));
+
+    //exit if allocation wasn't successful
+    if(queue == NULL){
+        return NULL;
+    }
+
+    //chunks are allocated lazily on the first push
+    queue->ll              = NULL;
+    queue->head_data       = 0;
+    queue->storage         = QUEUE_STORAGE_CHUNKED;
+    queue->size            = 0;
+    queue->head            = NULL;
+    queue->tail            = NULL;
+    queue->head_index      = QUEUE_CHUNK_CAPACITY;
+    queue->tail_index      = QUEUE_CHUNK_CAPACITY;
+    queue->head_end        = QUEUE_CHUNK_CAPACITY;
+    queue->spare           = NULL;
+    queue->spare_count     = 0;
+    queue->ring            = NULL;
+    queue->ring_mask       = 0;
+    queue->ring_head       = 0;
+    queue->high_water_mark = SIZE_MAX;
+    queue->allocator       = *allocator;
+
+    return queue;
+}
 
 // Creates a new queue.
 // PRECONDITION: Register malloc() and free() functions via the
@@ -41,31 +241,51 @@ static void   (*free_fptr)(void* addr)    = NULL;
 // Returns a new linked_list on success, NULL on failure.
 //
 struct queue * queue_create(void){
-    //check if malloc_fptr is NULL
-    if(malloc_fptr == NULL){
+    return queue_alloc(&default_allocator);
+}
+
+// Creates a new chunked queue that allocates through its own
+// allocator context.
+// \param allocator : Allocator context, copied into the queue.
+// Returns a new queue on success, NULL on failure.
+//
+struct queue * queue_create_with_allocator(const struct allocator * allocator){
+    //check if input is NULL or incomplete
+    if(allocator == NULL || allocator->alloc == NULL || allocator->free == NULL){
         return NULL;
     }
-    //allocate queue
-    struct queue *queue = (struct queue *)malloc_fptr(sizeof(struct queue));
+    return queue_alloc(allocator);
+}
 
-    //exit if allocation wasn't successful
+// Creates a new queue backed by a single contiguous ring buffer.
+// \param hint : Expected maximum number of entries.
+// Returns a new queue on success, NULL on failure.
+//
+struct queue * queue_create_with_capacity(size_t hint){
+    //round the hint up to a power of two
+    size_t capacity = QUEUE_RING_MIN_CAPACITY;
+    while(capacity < hint){
+        if(capacity > SIZE_MAX / (2 * sizeof(unsigned int))){
+            return NULL;
+        }
+        capacity *= 2;
+    }
+
+    struct queue * queue = queue_alloc(&default_allocator);
     if(queue == NULL){
         return NULL;
     }
 
-    //allocate underlying linkedlist
-    queue->ll = linked_list_create();
-
-    //exit if linkedlist allocation wasn't successful
-    if(queue->ll == NULL){
-        //free allocated queue before exit
-        free_fptr(queue);
+    //reserve the whole buffer up front
+    queue->ring = (unsigned int *)queue_malloc(queue, capacity * sizeof(unsigned int));
+    if(queue->ring == NULL){
+        queue_free(queue, queue);
         return NULL;
     }
+    queue->storage   = QUEUE_STORAGE_RING;
+    queue->ring_mask = capacity - 1;
 
-    //return queue if everything was successful
     return queue;
-
 }
 
 // Deletes a linked_list.
@@ -73,20 +293,32 @@ struct queue * queue_create(void){
 // Returns TRUE on success, FALSE otherwise.
 //
 bool queue_delete(struct queue * queue){
-    //check if input is NULL and free_fptr is NULL
-    if(queue == NULL || free_fptr == NULL){
+    //check if input is NULL, a queue that exists can always be freed
+    if(queue == NULL){
         return false;
     }
 
-    //free all nodes of the underlying linkedlist
-    //store result of operation
-    bool successful = linked_list_delete(queue->ll);
+    //free every chunk still linked into the queue, then the spares
+    struct queue_chunk * lists[2] = { queue->head, queue->spare };
+    for(size_t i = 0; i < 2; i++){
+        struct queue_chunk * curr = lists[i];
+        while(curr != NULL){
+            struct queue_chunk * next = curr->next;
+            queue_free(queue, curr);
+            curr = next;
+        }
+    }
 
-    //free the allocated queue
-    free_fptr(queue);
+    //free the ring buffer, if any
+    if(queue->ring != NULL){
+        queue_free(queue, queue->ring);
+    }
 
-    //return result of linkedlist deletion
-    return successful;
+    //free the allocated queue, through a copy of the context it lives in
+    struct allocator allocator = queue->allocator;
+    allocator.free(allocator.state, queue);
+
+    return true;
 }
 
 // Pushes an unsigned int onto the queue.
@@ -100,13 +332,133 @@ bool queue_push(struct queue * queue, unsigned int data){
         return false;
     }
 
-    bool success = linked_list_insert_end(queue->ll, data);
-    if(success){
-        queue->head_data = queue->ll->head->data;
+    if(queue->storage == QUEUE_STORAGE_RING){
+        //ring is full, double it
+        if(queue->size > queue->ring_mask && !queue_ring_reserve(queue, queue->size + 1)){
+            return false;
+        }
+        queue->ring[(queue->ring_head + queue->size) & queue->ring_mask] = data;
+        queue->size++;
+        return true;
     }
 
-    //push at the tail (back) of linkedlist and return operation result
-    return success;
+    //tail chunk is full (or there is no chunk yet), link a new one in
+    if(queue->tail_index == QUEUE_CHUNK_CAPACITY){
+        struct queue_chunk * chunk = queue_chunk_acquire(queue);
+        if(chunk == NULL){
+            return false;
+        }
+
+        if(queue->tail == NULL){
+            queue->head       = chunk;
+            queue->head_index = 0;
+        }
+        else{
+            queue->tail->next = chunk;
+        }
+        queue->tail       = chunk;
+        queue->tail_index = 0;
+    }
+
+    //append at the tail (back) of the queue
+    queue->tail->data[queue->tail_index++] = data;
+    queue->size++;
+
+    return true;
+}
+
+// Pushes an array of unsigned ints onto the queue, in order.
+// \param queue : Pointer to queue.
+// \param data  : Data to insert.
+// \param n     : Number of entries in data.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_push_bulk(struct queue * queue, const unsigned int * data, size_t n){
+    //check if queue is allocated and not NULL
+    if(queue == NULL || (data == NULL && n > 0)){
+        return false;
+    }
+    if(n == 0){
+        return true;
+    }
+
+    if(queue->storage == QUEUE_STORAGE_RING){
+        //grow once for the whole batch
+        if(queue->size > SIZE_MAX - n || !queue_ring_reserve(queue, queue->size + n)){
+            return false;
+        }
+
+        //copy up to the end of the buffer, then whatever wraps around
+        size_t capacity = queue->ring_mask + 1;
+        size_t start    = (queue->ring_head + queue->size) & queue->ring_mask;
+        size_t first    = capacity - start;
+        if(first > n){
+            first = n;
+        }
+        memcpy(queue->ring + start, data, first * sizeof(unsigned int));
+        memcpy(queue->ring, data + first, (n - first) * sizeof(unsigned int));
+        queue->size += n;
+        return true;
+    }
+
+    //grab every chunk the batch needs before touching the queue, so
+    //that running out of memory leaves the queue as it was
+    size_t tail_room = QUEUE_CHUNK_CAPACITY - queue->tail_index;
+    struct queue_chunk * first_chunk = NULL;
+    struct queue_chunk * last_chunk  = NULL;
+    if(n > tail_room){
+        size_t chunks = (n - tail_room + QUEUE_CHUNK_CAPACITY - 1) / QUEUE_CHUNK_CAPACITY;
+        for(size_t i = 0; i < chunks; i++){
+            struct queue_chunk * chunk = queue_chunk_acquire(queue);
+            if(chunk == NULL){
+                while(first_chunk != NULL){
+                    struct queue_chunk * next = first_chunk->next;
+                    queue_chunk_release(queue, first_chunk);
+                    first_chunk = next;
+                }
+                return false;
+            }
+            if(last_chunk == NULL){
+                first_chunk = chunk;
+            }
+            else{
+                last_chunk->next = chunk;
+            }
+            last_chunk = chunk;
+        }
+    }
+
+    //fill whatever room is left in the current tail chunk
+    size_t copied = n < tail_room ? n : tail_room;
+    if(copied > 0){
+        memcpy(queue->tail->data + queue->tail_index, data, copied * sizeof(unsigned int));
+        queue->tail_index += copied;
+    }
+
+    //then link the new chunks in and fill them front to back
+    if(first_chunk != NULL){
+        if(queue->tail == NULL){
+            queue->head       = first_chunk;
+            queue->head_index = 0;
+        }
+        else{
+            queue->tail->next = first_chunk;
+        }
+
+        for(struct queue_chunk * chunk = first_chunk; chunk != NULL; chunk = chunk->next){
+            size_t count = n - copied;
+            if(count > QUEUE_CHUNK_CAPACITY){
+                count = QUEUE_CHUNK_CAPACITY;
+            }
+            memcpy(chunk->data, data + copied, count * sizeof(unsigned int));
+            copied += count;
+            queue->tail       = chunk;
+            queue->tail_index = count;
+        }
+    }
+
+    queue->size += n;
+    return true;
 }
 
 // Pops an unsigned int from the queue, if one exists.
@@ -115,21 +467,235 @@ bool queue_push(struct queue * queue, unsigned int data){
 // Returns TRUE on success, FALSE otherwise.
 //
 bool queue_pop(struct queue * queue, unsigned int * popped_data){
-    //check if queue, underlying linkedlist and linkedlist head is allocated and not NULL
-    if(queue == NULL || queue->ll == NULL || queue->ll->head == NULL || popped_data == NULL){
+    //check if queue is allocated and non-empty
+    if(queue == NULL || queue->size == 0 || popped_data == NULL){
         return false;
     }
 
+    if(queue->storage == QUEUE_STORAGE_RING){
+        //popping is just advancing the head index, nothing is freed
+        *popped_data = queue->ring[queue->ring_head];
+        queue->ring_head = (queue->ring_head + 1) & queue->ring_mask;
+        queue->size--;
+        return true;
+    }
+
     //get data at head (front) of queue
-    *popped_data = queue->head_data;
+    *popped_data = queue->head->data[queue->head_index++];
+    queue->size--;
+    queue_chunk_settle(queue);
 
-    bool success = linked_list_remove(queue->ll, 0);
-    if(success && queue->ll->size > 0){
-        queue->head_data = queue->ll->head->data;
+    return true;
+}
+
+// Pops up to max unsigned ints from the queue into a caller provided
+// buffer, in FIFO order.
+// \param queue  : Pointer to queue.
+// \param out    : Buffer of at least max entries (provided by caller).
+// \param max    : Maximum number of entries to pop.
+// \param popped : Pointer to number of entries actually popped.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_pop_bulk(struct queue * queue, unsigned int * out, size_t max, size_t * popped){
+    if(popped != NULL){
+        *popped = 0;
+    }
+    //check if queue is allocated and non-empty
+    if(queue == NULL || out == NULL || popped == NULL || queue->size == 0 || max == 0){
+        return false;
     }
 
-    //pop the head at index 0 and return operation result
-    return success;
+    size_t n = max < queue->size ? max : queue->size;
+
+    if(queue->storage == QUEUE_STORAGE_RING){
+        //copy up to the end of the buffer, then whatever wrapped around
+        size_t first = queue->ring_mask + 1 - queue->ring_head;
+        if(first > n){
+            first = n;
+        }
+        memcpy(out, queue->ring + queue->ring_head, first * sizeof(unsigned int));
+        memcpy(out + first, queue->ring, (n - first) * sizeof(unsigned int));
+        queue->ring_head = (queue->ring_head + n) & queue->ring_mask;
+        queue->size -= n;
+        *popped = n;
+        return true;
+    }
+
+    //copy out of each chunk in turn, releasing the ones that drain
+    size_t copied = 0;
+    while(copied < n){
+        size_t end   = queue->head == queue->tail ? queue->tail_index : queue->head_end;
+        size_t count = end - queue->head_index;
+        if(count > n - copied){
+            count = n - copied;
+        }
+        memcpy(out + copied, queue->head->data + queue->head_index, count * sizeof(unsigned int));
+        copied            += count;
+        queue->head_index += count;
+        queue->size       -= count;
+        queue_chunk_settle(queue);
+    }
+
+    *popped = n;
+    return true;
+}
+
+// Empties the queue, keeping its storage up to the high water mark.
+// \param queue : Pointer to queue.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_clear(struct queue * queue){
+    //check if queue is allocated and not NULL
+    if(queue == NULL){
+        return false;
+    }
+
+    if(queue->storage == QUEUE_STORAGE_RING){
+        queue->size      = 0;
+        queue->ring_head = 0;
+        //release the buffer if it has grown past the high water mark
+        size_t capacity = QUEUE_RING_MIN_CAPACITY;
+        while(capacity < queue->high_water_mark && capacity <= queue->ring_mask){
+            capacity *= 2;
+        }
+        if(capacity <= queue->ring_mask){
+            unsigned int * ring = (unsigned int *)queue_malloc(queue, capacity * sizeof(unsigned int));
+            //keeping the big buffer is fine if a smaller one can't be had
+            if(ring != NULL){
+                queue_free(queue, queue->ring);
+                queue->ring      = ring;
+                queue->ring_mask = capacity - 1;
+            }
+        }
+        return true;
+    }
+
+    //move every live chunk onto the spare list
+    if(queue->head != NULL){
+        size_t chunks = 1;
+        for(struct queue_chunk * chunk = queue->head; chunk != queue->tail; chunk = chunk->next){
+            chunks++;
+        }
+        queue->tail->next   = queue->spare;
+        queue->spare        = queue->head;
+        queue->spare_count += chunks;
+    }
+    queue_chunk_trim(queue);
+
+    queue->size       = 0;
+    queue->head       = NULL;
+    queue->tail       = NULL;
+    queue->head_index = QUEUE_CHUNK_CAPACITY;
+    queue->tail_index = QUEUE_CHUNK_CAPACITY;
+    queue->head_end   = QUEUE_CHUNK_CAPACITY;
+
+    return true;
+}
+
+// Moves every entry of src onto the back of dst, leaving src empty.
+// \param dst : Pointer to queue to append to.
+// \param src : Pointer to queue to take the entries from.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_append(struct queue * dst, struct queue * src){
+    //check if input is NULL, the same queue or storage that can't be shared
+    if(dst == NULL || src == NULL || dst == src || dst->storage != src->storage){
+        return false;
+    }
+    if(src->size == 0){
+        return true;
+    }
+
+    if(dst->storage == QUEUE_STORAGE_RING){
+        //grow once, after which the copies can't fail
+        if(dst->size > SIZE_MAX - src->size || !queue_ring_reserve(dst, dst->size + src->size)){
+            return false;
+        }
+        size_t first = src->ring_mask + 1 - src->ring_head;
+        if(first > src->size){
+            first = src->size;
+        }
+        queue_push_bulk(dst, src->ring + src->ring_head, first);
+        queue_push_bulk(dst, src->ring, src->size - first);
+        src->size      = 0;
+        src->ring_head = 0;
+        return true;
+    }
+
+    //chunks can only change hands within one allocator context
+    if(!allocator_equal(&dst->allocator, &src->allocator)){
+        return false;
+    }
+
+    //chunks in the middle of a queue are consumed from slot 0, so shift
+    //what is left of the head chunk of src down
+    if(src->head_index > 0){
+        size_t end = src->head == src->tail ? src->tail_index : src->head_end;
+        memmove(src->head->data, src->head->data + src->head_index,
+                (end - src->head_index) * sizeof(unsigned int));
+        if(src->head == src->tail){
+            src->tail_index -= src->head_index;
+        }
+        else{
+            src->head->end -= (unsigned int)src->head_index;
+            src->head_end   = src->head->end;
+        }
+        src->head_index = 0;
+    }
+
+    if(dst->size == 0){
+        //nothing to keep in dst, its drained chunk (if any) becomes a spare
+        if(dst->head != NULL){
+            queue_chunk_release(dst, dst->head);
+        }
+        dst->head       = src->head;
+        dst->head_index = 0;
+        dst->head_end   = src->head->end;
+    }
+    else{
+        //cut the tail chunk of dst short and link src in after it
+        dst->tail->end  = (unsigned int)dst->tail_index;
+        dst->tail->next = src->head;
+        if(dst->head == dst->tail){
+            dst->head_end = dst->tail_index;
+        }
+    }
+    dst->tail       = src->tail;
+    dst->tail_index = src->tail_index;
+    dst->size      += src->size;
+
+    //src keeps its spares but no longer owns any live chunk
+    src->size       = 0;
+    src->head       = NULL;
+    src->tail       = NULL;
+    src->head_index = QUEUE_CHUNK_CAPACITY;
+    src->tail_index = QUEUE_CHUNK_CAPACITY;
+    src->head_end   = QUEUE_CHUNK_CAPACITY;
+
+    return true;
+}
+
+// Sets how much storage the queue keeps once it is emptied.
+// \param queue   : Pointer to queue.
+// \param entries : Number of entries worth of storage to keep.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_set_high_water_mark(struct queue * queue, size_t entries){
+    //check if queue is allocated and not NULL
+    if(queue == NULL){
+        return false;
+    }
+
+    queue->high_water_mark = entries;
+    if(queue->storage == QUEUE_STORAGE_CHUNKED){
+        queue_chunk_trim(queue);
+    }
+    else if(queue->size == 0){
+        //nothing live, so the ring can be trimmed right away
+        return queue_clear(queue);
+    }
+
+    return true;
 }
 
 // Returns the size of the queue.
@@ -142,8 +708,7 @@ size_t queue_size(struct queue * queue){
         return SIZE_MAX;
     }
 
-    //return underlying linkedlist size
-    return linked_list_size(queue->ll);
+    return queue->size;
 }
 
 // Returns whether an entry exists to be popped.
@@ -151,13 +716,13 @@ size_t queue_size(struct queue * queue){
 // Returns TRUE if an entry can be popped, FALSE otherwise.
 //
 bool queue_has_next(struct queue * queue){
-    //check if queue and underlying linkedlist is allocated and not NULL
-    if(queue == NULL || queue->ll == NULL){
+    //check if queue is allocated and not NULL
+    if(queue == NULL){
         return false;
     }
 
     //true if elements exist
-    return queue->ll->size > 0;
+    return queue->size > 0;
 }
 
 // Returns the value at the head of the queue, but does
@@ -167,13 +732,18 @@ bool queue_has_next(struct queue * queue){
 // Returns TRUE on success, FALSE otherwise.
 //
 bool queue_next(struct queue * queue, unsigned int * popped_data){
-    //check if queue, underlying linkedlist and if linkedlist atleast 1 element and not NULL
-    if(queue == NULL || queue->ll == NULL || queue->ll->size == 0 || popped_data == NULL){
+    //check if queue is allocated and has atleast 1 element
+    if(queue == NULL || queue->size == 0 || popped_data == NULL){
         return false;
     }
 
     //get data at head of queue
-    *popped_data = queue->head_data;
+    if(queue->storage == QUEUE_STORAGE_RING){
+        *popped_data = queue->ring[queue->ring_head];
+    }
+    else{
+        *popped_data = queue->head->data[queue->head_index];
+    }
 
     return true;
 }
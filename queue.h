@@ -14,19 +14,94 @@
 //    test infrastructure a bit more flexility. See linked_list.c for
 //    declarations of those function pointers.
 
+// Number of unsigned ints held by a single queue chunk. Chosen so
+// that a chunk (data plus its next pointer and end) is 16 KiB on a
+// 64-bit machine, i.e. one malloc() per ~4000 pushes instead of one
+// per push.
+//
+#define QUEUE_CHUNK_CAPACITY 4093
+
+// A fixed size block of queue entries. Chunks are linked together
+// oldest to newest, and entries within a chunk are consumed in order,
+// so pops walk memory sequentially instead of chasing a pointer per
+// element.
+//
+// end is the number of slots in use, QUEUE_CHUNK_CAPACITY for every
+// chunk except one whose tail was cut short by queue_append().
+//
+struct queue_chunk {
+    struct queue_chunk * next;
+    unsigned int end;
+    unsigned int data[QUEUE_CHUNK_CAPACITY];
+};
+
+// Smallest ring buffer a queue will allocate, in entries.
+//
+#define QUEUE_RING_MIN_CAPACITY 16
+
+// Backing storage used by a queue. Picked at creation time and fixed
+// for the lifetime of the queue.
+//
+enum queue_storage {
+    // Unrolled list of QUEUE_CHUNK_CAPACITY sized chunks. Memory grows
+    // and shrinks with the number of live entries. Used by queue_create().
+    QUEUE_STORAGE_CHUNKED,
+    // One contiguous power-of-two ring buffer that doubles when full.
+    // Used by queue_create_with_capacity().
+    QUEUE_STORAGE_RING
+};
+
 // Definition of the queue.
-// 
+//
+// The queue used to wrap a linked_list, which cost a malloc()/free()
+// pair and a 16 byte node per 4 byte entry. It is now backed by one of
+// two storage schemes (see enum queue_storage), both of which allocate
+// rarely and touch memory sequentially.
+//
+// Chunked storage: pops are served from head->data[head_index] and
+// pushes go to tail->data[tail_index]. An empty queue that owns no
+// chunks has head == tail == NULL and both indices equal to
+// QUEUE_CHUNK_CAPACITY, which lets queue_push() detect "needs a new
+// chunk" with a single comparison. head_end caches head->end, so pops
+// know where the head chunk stops without touching its header.
+//
+// Ring storage: the oldest entry is ring[ring_head], and the entry at
+// position i lives at ring[(ring_head + i) & ring_mask]. The capacity
+// is always ring_mask + 1, a power of two.
+//
 struct queue {
+    // Members of the original linked_list backed queue, kept per rule 1
+    // above. Neither is used any more: ll is always NULL and head_data
+    // always 0.
     struct linked_list* ll;
-    //storing data at head
-    //improved performance by very slightly
-    //(probably within error margin)
     unsigned int head_data;
 
+    enum queue_storage storage;
+    size_t size;
+
+    struct queue_chunk * head;
+    struct queue_chunk * tail;
+    size_t head_index;
+    size_t tail_index;
+    size_t head_end;
+
+    // Drained chunks are kept on this list (linked through next)
+    // rather than freed, so that later pushes, including ones after a
+    // queue_clear(), reuse them instead of calling malloc(). At most
+    // queue_spare_limit() chunks are kept.
+    struct queue_chunk * spare;
+    size_t spare_count;
+
+    unsigned int * ring;
+    size_t ring_mask;
+    size_t ring_head;
 
-    //storing the queue size worsened
-    //performance slightly
-    //size_t size; 
+    // Number of entries worth of storage the queue holds on to once
+    // it has been emptied. See queue_set_high_water_mark().
+    size_t high_water_mark;
+
+    // Allocator context the queue and all of its storage come from.
+    struct allocator allocator;
 };
 
 
@@ -38,6 +113,28 @@ struct queue {
 //
 struct queue * queue_create(void);
 
+// Creates a new queue backed by a single contiguous ring buffer, sized
+// up front so that pushes don't allocate until the hint is exceeded.
+// The buffer doubles whenever it fills up, and pops never free memory.
+// PRECONDITION: Register malloc() and free() functions via the
+//               queue_register_malloc() and
+//               queue_register_free() functions.
+// \param hint : Expected maximum number of entries. Rounded up to a
+//               power of two, and to at least QUEUE_RING_MIN_CAPACITY.
+// Returns a new queue on success, NULL on failure.
+//
+struct queue * queue_create_with_capacity(size_t hint);
+
+// Creates a new chunked queue, like queue_create(), that allocates the
+// queue and its chunks through its own allocator context instead of
+// the registered malloc() and free() functions. Queues with different
+// contexts share no state, so each thread can give its queues a
+// context of its own, e.g. a thread local arena, without locking.
+// \param allocator : Allocator context, copied into the queue.
+// Returns a new queue on success, NULL on failure.
+//
+struct queue * queue_create_with_allocator(const struct allocator * allocator);
+
 // Deletes a linked_list.
 // \param queue : Pointer to queue to delete
 // Returns TRUE on success, FALSE otherwise.
@@ -51,6 +148,16 @@ bool queue_delete(struct queue * queue);
 //
 bool queue_push(struct queue * queue, unsigned int data);
 
+// Pushes n unsigned ints onto the queue, in order, as if queue_push()
+// were called for each of them. Space for the whole batch is reserved
+// up front and the data is copied in with memcpy().
+// \param queue : Pointer to queue.
+// \param data  : Array of data to insert.
+// \param n     : Number of entries in data.
+// Returns TRUE on success, FALSE otherwise. On failure nothing is pushed.
+//
+bool queue_push_bulk(struct queue * queue, const unsigned int * data, size_t n);
+
 // Pops an unsigned int from the queue, if one exists.
 // \param queue       : Pointer to queue.
 // \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
@@ -58,6 +165,52 @@ bool queue_push(struct queue * queue, unsigned int data);
 //
 bool queue_pop(struct queue * queue, unsigned int * popped_data); 
 
+// Pops up to max unsigned ints from the queue in one call, in the same
+// order repeated queue_pop() calls would return them.
+// \param queue  : Pointer to queue.
+// \param out    : Buffer (provided by caller) with room for max entries.
+// \param max    : Maximum number of entries to pop.
+// \param popped : Pointer to the number of entries popped (provided by caller).
+//                 Set to 0 on failure.
+// Returns TRUE if at least one entry was popped, FALSE otherwise.
+//
+bool queue_pop_bulk(struct queue * queue, unsigned int * out, size_t max, size_t * popped);
+
+// Empties the queue without giving its storage back, so that a long
+// lived queue can be reused (e.g. for search after search) without any
+// allocator traffic once it is warm. Storage beyond the queue's high
+// water mark is released, see queue_set_high_water_mark().
+// Chunked queues take O(chunks), ring buffer queues O(1).
+// \param queue : Pointer to queue.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_clear(struct queue * queue);
+
+// Moves every entry of src onto the back of dst, in order, leaving src
+// empty. Chunked queues hand their chunks over rather than copying
+// them, so this is O(1) however many entries src holds: at most one
+// partly consumed chunk is shifted down. Ring buffer queues copy.
+// PRECONDITION: dst and src use the same storage and, for chunked
+//               queues, the same allocator context.
+// \param dst : Pointer to queue to append to.
+// \param src : Pointer to queue to take the entries from.
+// Returns TRUE on success, FALSE otherwise. Both queues are unchanged on failure.
+//
+bool queue_append(struct queue * dst, struct queue * src);
+
+// Sets how much storage the queue keeps once it is emptied, either by
+// queue_clear() or by popping. Anything above the mark is freed, and
+// storage already held beyond it is trimmed immediately.
+// Chunked queues round the mark down to whole chunks, ring buffer
+// queues round it up to a power of two; both always keep at least one
+// chunk or QUEUE_RING_MIN_CAPACITY entries. The default is SIZE_MAX,
+// i.e. keep everything.
+// \param queue   : Pointer to queue.
+// \param entries : Number of entries worth of storage to keep.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool queue_set_high_water_mark(struct queue * queue, size_t entries);
+
 // Returns the size of the queue.
 // \param queue : Pointer to queue.
 // Returns size on success, SIZE_MAX otherwise.
@@ -0,0 +1,225 @@
+#ifndef _QUEUE_GENERIC_H
+#define _QUEUE_GENERIC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "allocator.h"
+
+// Target size of one chunk of a generated queue, in bytes. The same
+// 16 KiB that struct queue_chunk in queue.h works out to.
+//
+#define QUEUE_GENERIC_CHUNK_BYTES 16384
+
+// Compile time generated, typed FIFO queues.
+//
+// DEFINE_QUEUE(name, T) expands to a queue of T laid out like the
+// chunked storage of struct queue (see queue.h): elements are stored
+// by value in fixed size chunks linked oldest to newest, pushes go to
+// tail->data[tail_index] and pops come from head->data[head_index].
+// So a queue of (vertex, depth) pairs or of 64-bit ids costs one
+// allocation per chunk and no pointer per element. Everything is
+// static inline, so push and pop compile down to a bounds check and a
+// store or load in the common case.
+//
+// It defines:
+//
+//   name_chunk_capacity    elements per chunk, at least 1
+//   struct name_chunk      { next; T data[name_chunk_capacity]; }
+//   struct name            { size, head, tail, head_index, tail_index,
+//                            spare, allocator }
+//
+//   struct name * name_create(const struct allocator * allocator);
+//   bool          name_delete(struct name * queue);
+//   size_t        name_size(const struct name * queue);
+//   bool          name_has_next(const struct name * queue);
+//   bool          name_push(struct name * queue, T data);
+//   bool          name_pop(struct name * queue, T * popped_data);
+//   T *           name_peek(struct name * queue);
+//   bool          name_clear(struct name * queue);
+//
+// As in queue.c, an empty queue that owns no chunks has head == tail ==
+// NULL and both indices equal to the chunk capacity, and one drained
+// chunk is kept as a spare so a queue that hovers around a chunk
+// boundary doesn't allocate on every crossing. The queue and its
+// chunks come from the allocator context passed to name_create(), see
+// allocator.h. name_peek() returns a pointer to the oldest element,
+// valid until it is popped.
+//
+// Use it at file scope, once per element type:
+//
+//   struct visit { uint32_t vertex; uint32_t depth; };
+//   DEFINE_QUEUE(visit_queue, struct visit)
+//
+#define DEFINE_QUEUE(name, T)                                                   \
+                                                                                \
+enum { name##_chunk_capacity =                                                  \
+       (QUEUE_GENERIC_CHUNK_BYTES - sizeof(void *)) / sizeof(T) > 0 ?           \
+       (QUEUE_GENERIC_CHUNK_BYTES - sizeof(void *)) / sizeof(T) : 1 };          \
+                                                                                \
+struct name##_chunk {                                                           \
+    struct name##_chunk * next;                                                 \
+    T data[name##_chunk_capacity];                                              \
+};                                                                              \
+                                                                                \
+struct name {                                                                   \
+    size_t size;                                                                \
+    struct name##_chunk * head;                                                 \
+    struct name##_chunk * tail;                                                 \
+    size_t head_index;                                                          \
+    size_t tail_index;                                                          \
+    struct name##_chunk * spare;                                                \
+    struct allocator allocator;                                                 \
+};                                                                              \
+                                                                                \
+static inline struct name * name##_create(const struct allocator * allocator){  \
+    if(allocator == NULL || allocator->alloc == NULL || allocator->free == NULL){ \
+        return NULL;                                                            \
+    }                                                                           \
+    struct name * queue = (struct name *)allocator->alloc(allocator->state,     \
+                                                          sizeof(struct name)); \
+    if(queue == NULL){                                                          \
+        return NULL;                                                            \
+    }                                                                           \
+    queue->size       = 0;                                                      \
+    queue->head       = NULL;                                                   \
+    queue->tail       = NULL;                                                   \
+    queue->head_index = name##_chunk_capacity;                                  \
+    queue->tail_index = name##_chunk_capacity;                                  \
+    queue->spare      = NULL;                                                   \
+    queue->allocator  = *allocator;                                             \
+    return queue;                                                               \
+}                                                                               \
+                                                                                \
+static inline bool name##_delete(struct name * queue){                          \
+    if(queue == NULL){                                                          \
+        return false;                                                           \
+    }                                                                           \
+    struct allocator allocator = queue->allocator;                              \
+    struct name##_chunk * curr = queue->head;                                   \
+    while(curr != NULL){                                                        \
+        struct name##_chunk * next = curr->next;                                \
+        allocator.free(allocator.state, curr);                                  \
+        curr = next;                                                            \
+    }                                                                           \
+    if(queue->spare != NULL){                                                   \
+        allocator.free(allocator.state, queue->spare);                          \
+    }                                                                           \
+    allocator.free(allocator.state, queue);                                     \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline size_t name##_size(const struct name * queue){                    \
+    return queue == NULL ? SIZE_MAX : queue->size;                              \
+}                                                                               \
+                                                                                \
+static inline bool name##_has_next(const struct name * queue){                  \
+    return queue != NULL && queue->size > 0;                                    \
+}                                                                               \
+                                                                                \
+static inline bool name##_push_slow(struct name * queue, T data){               \
+    struct name##_chunk * chunk = queue->spare;                                 \
+    if(chunk != NULL){                                                          \
+        queue->spare = NULL;                                                    \
+    }                                                                           \
+    else{                                                                       \
+        chunk = (struct name##_chunk *)queue->allocator.alloc(                  \
+            queue->allocator.state, sizeof(struct name##_chunk));               \
+        if(chunk == NULL){                                                      \
+            return false;                                                       \
+        }                                                                       \
+    }                                                                           \
+    chunk->next = NULL;                                                         \
+    if(queue->tail == NULL){                                                    \
+        queue->head       = chunk;                                              \
+        queue->head_index = 0;                                                  \
+    }                                                                           \
+    else{                                                                       \
+        queue->tail->next = chunk;                                              \
+    }                                                                           \
+    queue->tail       = chunk;                                                  \
+    chunk->data[0]    = data;                                                   \
+    queue->tail_index = 1;                                                      \
+    queue->size++;                                                              \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline bool name##_push(struct name * queue, T data){                    \
+    if(queue == NULL){                                                          \
+        return false;                                                           \
+    }                                                                           \
+    if(queue->tail_index == name##_chunk_capacity){                             \
+        return name##_push_slow(queue, data);                                   \
+    }                                                                           \
+    queue->tail->data[queue->tail_index++] = data;                              \
+    queue->size++;                                                              \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline void name##_release(struct name * queue,                          \
+                                  struct name##_chunk * chunk){                 \
+    if(queue->spare == NULL){                                                   \
+        queue->spare = chunk;                                                   \
+    }                                                                           \
+    else{                                                                       \
+        queue->allocator.free(queue->allocator.state, chunk);                   \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static inline void name##_settle(struct name * queue){                          \
+    if(queue->head_index == name##_chunk_capacity){                             \
+        struct name##_chunk * drained = queue->head;                            \
+        queue->head       = drained->next;                                      \
+        queue->head_index = 0;                                                  \
+        name##_release(queue, drained);                                         \
+        if(queue->head == NULL){                                                \
+            queue->tail       = NULL;                                           \
+            queue->head_index = name##_chunk_capacity;                          \
+            queue->tail_index = name##_chunk_capacity;                          \
+        }                                                                       \
+    }                                                                           \
+    else if(queue->size == 0){                                                  \
+        queue->head_index = 0;                                                  \
+        queue->tail_index = 0;                                                  \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static inline bool name##_pop(struct name * queue, T * popped_data){            \
+    if(queue == NULL || queue->size == 0 || popped_data == NULL){               \
+        return false;                                                           \
+    }                                                                           \
+    *popped_data = queue->head->data[queue->head_index++];                      \
+    queue->size--;                                                              \
+    if(queue->head_index == name##_chunk_capacity || queue->size == 0){         \
+        name##_settle(queue);                                                   \
+    }                                                                           \
+    return true;                                                                \
+}                                                                               \
+                                                                                \
+static inline T * name##_peek(struct name * queue){                             \
+    if(queue == NULL || queue->size == 0){                                      \
+        return NULL;                                                            \
+    }                                                                           \
+    return &queue->head->data[queue->head_index];                               \
+}                                                                               \
+                                                                                \
+static inline bool name##_clear(struct name * queue){                           \
+    if(queue == NULL){                                                          \
+        return false;                                                           \
+    }                                                                           \
+    struct name##_chunk * curr = queue->head;                                   \
+    while(curr != NULL){                                                        \
+        struct name##_chunk * next = curr->next;                                \
+        name##_release(queue, curr);                                            \
+        curr = next;                                                            \
+    }                                                                           \
+    queue->size       = 0;                                                      \
+    queue->head       = NULL;                                                   \
+    queue->tail       = NULL;                                                   \
+    queue->head_index = name##_chunk_capacity;                                  \
+    queue->tail_index = name##_chunk_capacity;                                  \
+    return true;                                                                \
+}
+
+#endif
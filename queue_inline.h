@@ -0,0 +1,71 @@
+#ifndef _QUEUE_INLINE_H
+#define _QUEUE_INLINE_H
+
+#include "queue.h"
+
+// Header only fast paths for the hot queue operations.
+//
+// These work directly on the struct queue layout from queue.h and
+// behave exactly like queue_push() and queue_pop(), so the two can be
+// mixed freely on the same queue. Only the common case is handled
+// here: a store into the current tail chunk or a ring buffer with room
+// to spare, and a load that neither drains the head chunk nor empties
+// the queue. Anything else, including a NULL queue, is handed to the
+// out-of-line function, which owns all allocation and chunk
+// bookkeeping.
+//
+// Calls across libqueue.so can't be inlined, so code that pushes or
+// pops in a tight loop should include this header and use these
+// instead.
+//
+
+// Pushes an unsigned int onto the queue. Same contract as queue_push().
+// \param queue : Pointer to queue.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE otherwise.
+//
+static inline bool queue_push_inline(struct queue * queue, unsigned int data){
+    if(queue != NULL){
+        if(queue->storage == QUEUE_STORAGE_RING){
+            if(queue->size <= queue->ring_mask){
+                queue->ring[(queue->ring_head + queue->size) & queue->ring_mask] = data;
+                queue->size++;
+                return true;
+            }
+        }
+        else if(queue->tail_index < QUEUE_CHUNK_CAPACITY){
+            queue->tail->data[queue->tail_index++] = data;
+            queue->size++;
+            return true;
+        }
+    }
+    return queue_push(queue, data);
+}
+
+// Pops an unsigned int from the queue. Same contract as queue_pop().
+// \param queue       : Pointer to queue.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE otherwise.
+//
+static inline bool queue_pop_inline(struct queue * queue, unsigned int * popped_data){
+    if(queue != NULL && popped_data != NULL){
+        if(queue->storage == QUEUE_STORAGE_RING){
+            if(queue->size == 0){
+                return false;
+            }
+            *popped_data = queue->ring[queue->ring_head];
+            queue->ring_head = (queue->ring_head + 1) & queue->ring_mask;
+            queue->size--;
+            return true;
+        }
+        //leave the last entry of a chunk, and of the queue, to queue_pop()
+        if(queue->size > 1 && queue->head_index + 1 < queue->head_end){
+            *popped_data = queue->head->data[queue->head_index++];
+            queue->size--;
+            return true;
+        }
+    }
+    return queue_pop(queue, popped_data);
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -11,18 +12,15 @@
 #include "arm_pmu.h"
 #endif
 
-#include "mmio.h"
+#include "graph.h"
 #include "queue.h"
+#include "queue_inline.h"
 
-// A hacky adjacency matrix. 
+// The Wikipedia graph in CSR form, and which of its vertices the
+// current search has expanded.
 //
-struct row {
-    size_t size;
-    unsigned int * adjacent_nodes;
-    bool visited;
-};
-
-struct row ** rows = NULL; 
+struct graph * graph = NULL;
+bool * visited       = NULL;
 
 // Malloc and free implementations and microbenchmarking.
 //
@@ -93,7 +91,8 @@ void instrumented_free(void * addr) {
 void sum_timespec(struct timespec *destination,
                   struct timespec additional_time) {
     destination->tv_nsec += additional_time.tv_nsec;
-    if (destination->tv_nsec > 1000000000L) {
+    if (destination->tv_nsec >= 1000000000L) {
+        destination->tv_nsec -= 1000000000L;
         ++destination->tv_sec;
     }
 
@@ -102,22 +101,14 @@ void sum_timespec(struct timespec *destination,
 
 long compute_timespec_diff(struct timespec start,
                            struct timespec stop) {
-    long nanoseconds;
-    nanoseconds = (stop.tv_sec - start.tv_sec) * 1000000000L;
-
-    if (start.tv_nsec > stop.tv_nsec) {
-        nanoseconds -= 1000000000L;
-	nanoseconds += (start.tv_nsec - stop.tv_nsec);
-    } else {
-        nanoseconds += (stop.tv_nsec - start.tv_nsec);
-    }
-
-    return nanoseconds;
+    return (stop.tv_sec - start.tv_sec) * 1000000000L +
+           (stop.tv_nsec - start.tv_nsec);
 }
 
-bool breadth_first_search(unsigned int i, unsigned int j) {
-    struct queue * queue = queue_create();
-
+// The queue is created once by main() and reused for every search.
+// It is empty on entry and cleared (keeping its memory) on exit.
+//
+bool breadth_first_search(struct queue * queue, unsigned int i, unsigned int j) {
     bool found_path = false;
     unsigned int next_node = i;
     size_t node_count = 0;
@@ -125,44 +116,46 @@ bool breadth_first_search(unsigned int i, unsigned int j) {
     alarm(TIMEOUT_SECONDS);
     GRAB_CLOCK(start)
     while(!found_path) {
-        // Push data onto the queue.
+        // Push data onto the queue. Vertices without out-edges are
+        // never marked visited, just popped past.
 	//
-        struct row * row = rows[next_node];
+        uint32_t degree = next_node < graph->vertex_count ? graph_degree(graph, next_node) : 0;
 
-	if (row == NULL || row->visited) {
-            bool not_done = queue_pop(queue, &next_node);
+	if (degree == 0 || visited[next_node]) {
+            bool not_done = queue_pop_inline(queue, &next_node);
 	    ++node_count;
 	    if (!not_done) break;
 	    continue;
 	} else {
-            row->visited = true;
+            visited[next_node] = true;
 	}
 
-	if (row != NULL) {
-	    for(size_t node = 0; node < row->size; node++) {
-                unsigned int data = row->adjacent_nodes[node];
-	        // Check if we found the node.
-	        //
-	        if (j == data) {
-                    found_path = true;
-	        }
-                bool sanity = queue_push(queue, row->adjacent_nodes[node]);
-		if (!sanity) {
-                    printf("Error pushing into queue.\n");
-		    return 1;
-		}
+	const uint32_t * neighbors = graph_neighbors(graph, next_node);
+	for(uint32_t node = 0; node < degree; node++) {
+	    // Check if we found the node.
+	    //
+	    if (j == neighbors[node]) {
+                found_path = true;
 	    }
 	}
 
+	// Push the whole adjacency row in one go.
+	//
+        bool sanity = queue_push_bulk(queue, neighbors, degree);
+	if (!sanity) {
+            printf("Error pushing into queue.\n");
+	    return 1;
+	}
+
 	// Pop the next row off the queue.
 	//
-	bool full = queue_pop(queue, &next_node);
+	bool full = queue_pop_inline(queue, &next_node);
 	if (!full) {
             break;
 	}
 	++node_count;
     }
-    queue_delete(queue);
+    queue_clear(queue);
     GRAB_CLOCK(stop)
     // Turn off the timeout.
     //
@@ -180,44 +173,6 @@ bool breadth_first_search(unsigned int i, unsigned int j) {
     return found_path;
 }
 
-void add_edge(unsigned int i, unsigned int j) {
-    // Check whether row i exists, if not allocate.
-    //
-    if (rows[i] == NULL) {
-        rows[i] = (struct row*)malloc(sizeof(struct row));
-
-        if (rows[i] == NULL) {
-            printf("Failed to allocate edge, exiting.\n");
-	    exit(1);
-	}
-
-	rows[i]->size              = 1;
-	rows[i]->adjacent_nodes    = malloc(16 * sizeof(unsigned int));
-	rows[i]->visited           = false;
-	if (rows[i]->adjacent_nodes == NULL) {
-            printf("Unable to malloc adjacent_nodes.\n");
-	    exit(1);
-	}
-	rows[i]->adjacent_nodes[0] = j;
-    } else {
-        // Check whether to perform realloc.
-	// Every 16 nodes we allocate another 16.
-	//
-	size_t size = rows[i]->size;
-	if (size % 16 == 15) {
-             rows[i]->adjacent_nodes = realloc(rows[i]->adjacent_nodes, (size + 1 + 16) * sizeof(unsigned int));
-
-	     if (rows[i] == NULL) {
-                 printf("Failed to realloc adjacent nodes.\n");
-		 exit(1);
-	     }
-	}
-
-	rows[i]->adjacent_nodes[size] = j;
-	++rows[i]->size;
-    }
-}
-
 int main(void) {
 
     // Initialize malloc() and free().
@@ -269,13 +224,17 @@ int main(void) {
     printf("Average time [ns] per malloc() call: %ld\n", average_malloc_time);
     printf("Average time [ns] per free() call: %ld\n", average_free_time);
 
-    // Parse the file.
+    // Load the graph.
     //
-    FILE* fptr      = fopen("wikipedia-20070206/wikipedia-20070206.mtx", "r");
+    struct timespec load_start, load_end;
+    GRAB_CLOCK(load_start)
+    graph           = graph_load("wikipedia-20070206/wikipedia-20070206.mtx",
+                                 "wikipedia-20070206/wikipedia-20070206.csr");
+    GRAB_CLOCK(load_end)
     FILE* node_fptr = fopen("nodes", "r"); 
 
-    if (fptr == NULL) {
-        printf("Error opening matrix.\n");
+    if (graph == NULL) {
+        printf("Error loading matrix.\n");
 	printf("Did you run 'make download_and_decompress_test_data'?\n");
         return 1;
     }
@@ -285,66 +244,35 @@ int main(void) {
 	return 1;
     }
 
-    MM_typecode matrix_code;
-
-    if (mm_read_banner(fptr, &matrix_code) != 0) {
-        printf("Malformed Matrix Market file.\n");
-	return 1;
+    printf("Wikipedia matrix size m: %u n: %u nz: %u\n",
+           graph->vertex_count - 1, graph->vertex_count - 1, graph->edge_count);
+    double load_seconds = (double)compute_timespec_diff(load_start, load_end) / 1e9;
+    printf("Loaded graph in [s]: %0.3f\n", load_seconds);
+    struct stat mtx_stat;
+    if (graph->mapping == NULL &&
+        stat("wikipedia-20070206/wikipedia-20070206.mtx", &mtx_stat) == 0) {
+        printf("Parsed the .mtx file at [MB/s]: %0.1f\n",
+               (double)mtx_stat.st_size / 1e6 / load_seconds);
     }
+    printf("Graph uses %zu bytes in CSR form.\n",
+           ((size_t)graph->vertex_count + 1 + graph->edge_count) * sizeof(uint32_t));
 
-    // Determine size of MxN matrix with total non-zero size nz.
-    //
-    int m, n, nz;
-    if (mm_read_mtx_crd_size(fptr, &m, &n, &nz)) {
-        printf("Unable to read size of matrix.\n");
+    visited = calloc(graph->vertex_count, sizeof(bool));
+    if (visited == NULL) {
+        printf("Failed to allocate visited array.\n");
 	return 1;
     }
 
-    if (m != n) {
-        printf("Matrix row and column size not equal. m: %d n: %d\n",
-               m, n);
-        return 1;
-    }
-
-    printf("Wikipedia matrix size m: %d n: %d nz: %d\n", m, n, nz);
-
-    // Start reading in the data.
-    //
-    rows = (struct row**)malloc(sizeof(struct row*) * (m + 1));
-    if (rows == NULL) {
-        printf("Failed to allocate row array.\n");
-	return 1;
-    }
-
-    printf("Allocated %ld bytes for row array.\n",
-           sizeof(struct row*) * m + 1);
-
-    // Zero out the row array.
-    // A NULL means that a particular node in the graph
-    // has no directed edges to other nodes.
-    //
-    for (int i = 0; i < m + 1; i++) {
-        rows[i] = NULL;
-    }
-
-    // Parse.
+    // One queue serves every search. A search pushes every out-edge of
+    // each vertex it visits at most once, so the number of non-zeros
+    // in the matrix bounds the queue size and the ring buffer never
+    // has to grow.
     //
-    size_t line_count = 0;
-    while(!feof(fptr)) {
-	// Grab next directed edge.
-	// A pair (i, j) means that node i links to node j.
-	//
-	unsigned int i, j;
-        int retval = fscanf(fptr, "%d %d", &i, &j);
-	if (!(retval == 2 || retval == -1)) {
-            printf("File parsing error with fscanf() return value of: %d.\n", retval);
-	    return 1;
-	}
-
-	add_edge(i, j);
-	++line_count;
+    struct queue * queue = queue_create_with_capacity((size_t)graph->edge_count);
+    if (queue == NULL) {
+        printf("Failed to create queue.\n");
+        return 1;
     }
-    printf("Read %ld lines of matrix data.\n", line_count);
 
     // Start the BFS.
     //
@@ -361,7 +289,7 @@ int main(void) {
 #ifdef COMPILE_ARM_PMU_CODE
 	reset_and_start_pmu_counters();
 #endif
-        bool success = breadth_first_search(node_i, node_j);
+        bool success = breadth_first_search(queue, node_i, node_j);
 #ifdef COMPILE_ARM_PMU_CODE
 	stop_pmu_counters();
 #endif
@@ -373,11 +301,7 @@ int main(void) {
 
 	// Clear visited fields for next run.
 	//
-        for (int j = 0; j < m + 1; j++) {
-            if (rows[j]) {
-                rows[j]->visited = false;
-	    }
-	}
+        memset(visited, 0, graph->vertex_count * sizeof(bool));
 
 	// Grab PMU data.
 	//
@@ -409,14 +333,10 @@ int main(void) {
 
     // Free
     //
-    for (int i = 0; i < m + 1; i++) {
-        if (rows[i] == NULL) continue;
-	free(rows[i]->adjacent_nodes);
-	free(rows[i]);
-    }
-
-    free(rows);
-    fclose(fptr);
+    free(visited);
+    graph_delete(graph);
+    queue_delete(queue);
+    fclose(node_fptr);
 
     return 0;
 }
@@ -0,0 +1,141 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "linked_list.h"
+
+// Sorts the same pseudo-random keys with linked_list_sort() and
+// linked_list_radix_sort(), on node and indexed lists, and compares
+// them with the copy-out alternative: extracting the list into an
+// array and calling qsort(). Every result is checked to be in order.
+// Usage:
+//
+//     ./sort_performance [elements]
+//
+#define GRAB_CLOCK(x) clock_gettime(CLOCK_MONOTONIC, &x);
+#define DEFAULT_ELEMENTS 4000000UL
+#define RUNS             3
+
+size_t elements = DEFAULT_ELEMENTS;
+
+long compute_timespec_diff(struct timespec start,
+                           struct timespec stop) {
+    return (stop.tv_sec - start.tv_sec) * 1000000000L +
+           (stop.tv_nsec - start.tv_nsec);
+}
+
+int compare_unsigned(const void * a, const void * b) {
+    unsigned int x = *(const unsigned int *)a;
+    unsigned int y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+// Builds a list of the same keys on every call.
+//
+struct linked_list * build_list(bool indexed) {
+    struct linked_list * ll = indexed ? linked_list_create_indexed() : linked_list_create();
+    if (ll == NULL) {
+        printf("Failed to create linked_list, exiting.\n");
+        exit(1);
+    }
+    unsigned int seed = 2463534242u;
+    for (size_t i = 0; i < elements; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        if (!linked_list_insert_end(ll, seed)) {
+            printf("Failed to insert, exiting.\n");
+            exit(1);
+        }
+    }
+    return ll;
+}
+
+bool list_is_sorted(struct linked_list * ll) {
+    struct span_iterator iter;
+    const unsigned int * data;
+    size_t length;
+    unsigned int previous = 0;
+    linked_list_span_begin(ll, &iter);
+    while (linked_list_next_span(&iter, &data, &length)) {
+        for (size_t i = 0; i < length; i++) {
+            if (data[i] < previous) {
+                return false;
+            }
+            previous = data[i];
+        }
+    }
+    return true;
+}
+
+// Copies the list out, sorts the copy with qsort() and writes it back.
+//
+bool qsort_extracted(struct linked_list * ll) {
+    unsigned int * array = malloc(elements * sizeof(unsigned int));
+    if (array == NULL) {
+        return false;
+    }
+    size_t removed = 0;
+    linked_list_remove_front_bulk(ll, array, elements, &removed);
+    qsort(array, removed, sizeof(unsigned int), compare_unsigned);
+    bool status = linked_list_insert_end_bulk(ll, array, removed);
+    free(array);
+    return status;
+}
+
+bool run_linked_list_sort(struct linked_list * ll) {
+    return linked_list_sort(ll);
+}
+
+bool run_linked_list_radix_sort(struct linked_list * ll) {
+    return linked_list_radix_sort(ll);
+}
+
+// Best of RUNS timings of one sort, in seconds.
+//
+double time_sort(const char * name, bool indexed, bool (*sort)(struct linked_list *)) {
+    double best = 0.0;
+    for (size_t run = 0; run < RUNS; run++) {
+        struct linked_list * ll = build_list(indexed);
+        struct timespec start, stop;
+
+        GRAB_CLOCK(start)
+        bool status = sort(ll);
+        GRAB_CLOCK(stop)
+
+        if (!status || linked_list_size(ll) != elements || !list_is_sorted(ll)) {
+            printf("%s produced a wrong result, exiting.\n", name);
+            exit(1);
+        }
+        linked_list_delete(ll);
+
+        double seconds = compute_timespec_diff(start, stop) / 1e9;
+        if (run == 0 || seconds < best) {
+            best = seconds;
+        }
+    }
+    printf("%-40s %8.3f s\n", name, best);
+    return best;
+}
+
+int main(int argc, char ** argv) {
+    if (argc > 1) {
+        elements = strtoul(argv[1], NULL, 10);
+    }
+
+    linked_list_register_malloc(malloc);
+    linked_list_register_free(free);
+
+    printf("Elements: %zu, best of %d runs\n", elements, RUNS);
+    time_sort("nodes, qsort() on extracted array",   false, qsort_extracted);
+    time_sort("nodes, linked_list_sort()",           false, run_linked_list_sort);
+    time_sort("nodes, linked_list_radix_sort()",     false, run_linked_list_radix_sort);
+    time_sort("indexed, qsort() on extracted array", true,  qsort_extracted);
+    time_sort("indexed, linked_list_sort()",         true,  run_linked_list_sort);
+    time_sort("indexed, linked_list_radix_sort()",   true,  run_linked_list_radix_sort);
+
+    linked_list_pool_destroy();
+    return 0;
+}
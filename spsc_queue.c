@@ -0,0 +1,243 @@
+/*
+*MIT License
+*
+*Copyright (c) 2025 Siddhant Nadkarni
+*
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*/
+
+
+
+#include "spsc_queue.h"
+
+// Function pointers to (potentially) custom malloc() and
+// free() functions.
+//
+static void * (*malloc_fptr)(size_t size) = NULL;
+static void   (*free_fptr)(void* addr)    = NULL;
+
+// Creates a new spsc_queue.
+// \param capacity : Maximum number of entries.
+// Returns a new spsc_queue on success, NULL on failure.
+//
+struct spsc_queue * spsc_queue_create(size_t capacity){
+    //check if malloc_fptr/free_fptr are NULL
+    if(malloc_fptr == NULL || free_fptr == NULL){
+        return NULL;
+    }
+
+    //round the capacity up to a power of two
+    size_t rounded = SPSC_QUEUE_MIN_CAPACITY;
+    while(rounded < capacity){
+        if(rounded > SIZE_MAX / (2 * sizeof(unsigned int))){
+            return NULL;
+        }
+        rounded *= 2;
+    }
+
+    //malloc_fptr() makes no promise about cache line alignment, so
+    //over-allocate and align the queue by hand
+    void * allocation = malloc_fptr(sizeof(struct spsc_queue) + SPSC_QUEUE_CACHE_LINE - 1);
+    if(allocation == NULL){
+        return NULL;
+    }
+    uintptr_t aligned = ((uintptr_t)allocation + SPSC_QUEUE_CACHE_LINE - 1) &
+                        ~(uintptr_t)(SPSC_QUEUE_CACHE_LINE - 1);
+    struct spsc_queue * queue = (struct spsc_queue *)aligned;
+
+    queue->buffer = (unsigned int *)malloc_fptr(rounded * sizeof(unsigned int));
+    if(queue->buffer == NULL){
+        free_fptr(allocation);
+        return NULL;
+    }
+
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    queue->cached_head = 0;
+    queue->cached_tail = 0;
+    queue->mask        = rounded - 1;
+    queue->allocation  = allocation;
+
+    return queue;
+}
+
+// Deletes a spsc_queue.
+// \param queue : Pointer to spsc_queue to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_delete(struct spsc_queue * queue){
+    //check if input is NULL and free_fptr is NULL
+    if(queue == NULL || free_fptr == NULL){
+        return false;
+    }
+
+    free_fptr(queue->buffer);
+    free_fptr(queue->allocation);
+
+    return true;
+}
+
+// Pushes an unsigned int onto the queue. Producer thread only.
+// \param queue : Pointer to spsc_queue.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE if the queue is full.
+//
+bool spsc_queue_push(struct spsc_queue * queue, unsigned int data){
+    if(queue == NULL){
+        return false;
+    }
+
+    //only this thread writes tail, so a relaxed load is enough
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    //looks full, see how far the consumer has actually got
+    if(tail - queue->cached_head > queue->mask){
+        queue->cached_head = atomic_load_explicit(&queue->head, memory_order_acquire);
+        if(tail - queue->cached_head > queue->mask){
+            return false;
+        }
+    }
+
+    queue->buffer[tail & queue->mask] = data;
+
+    //publish the entry, release orders the buffer write before it
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+// Pops an unsigned int from the queue, if one exists. Consumer thread only.
+// \param queue       : Pointer to spsc_queue.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_try_pop(struct spsc_queue * queue, unsigned int * popped_data){
+    if(queue == NULL || popped_data == NULL){
+        return false;
+    }
+
+    //only this thread writes head, so a relaxed load is enough
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    //looks empty, see whether the producer has published anything since
+    if(head == queue->cached_tail){
+        queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if(head == queue->cached_tail){
+            return false;
+        }
+    }
+
+    *popped_data = queue->buffer[head & queue->mask];
+
+    //hand the slot back, release orders the buffer read before it
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+
+    return true;
+}
+
+// Returns whether an entry exists to be popped. Consumer thread only.
+// \param queue : Pointer to spsc_queue.
+// Returns TRUE if an entry can be popped, FALSE otherwise.
+//
+bool spsc_queue_has_next(struct spsc_queue * queue){
+    if(queue == NULL){
+        return false;
+    }
+
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if(head != queue->cached_tail){
+        return true;
+    }
+
+    queue->cached_tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    return head != queue->cached_tail;
+}
+
+// Returns the value at the head of the queue, but does not pop it.
+// Consumer thread only.
+// \param queue       : Pointer to spsc_queue.
+// \param popped_data : Pointer to data (provided by caller), if one exists.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_next(struct spsc_queue * queue, unsigned int * popped_data){
+    if(popped_data == NULL || !spsc_queue_has_next(queue)){
+        return false;
+    }
+
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    *popped_data = queue->buffer[head & queue->mask];
+
+    return true;
+}
+
+// Returns the number of entries in the queue.
+// \param queue : Pointer to spsc_queue.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t spsc_queue_size(struct spsc_queue * queue){
+    if(queue == NULL){
+        return SIZE_MAX;
+    }
+
+    //read head first: tail only grows, so the result can't go negative
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    return tail - head;
+}
+
+// Returns the maximum number of entries the queue can hold.
+// \param queue : Pointer to spsc_queue.
+// Returns capacity on success, SIZE_MAX otherwise.
+//
+size_t spsc_queue_capacity(struct spsc_queue * queue){
+    if(queue == NULL){
+        return SIZE_MAX;
+    }
+
+    return queue->mask + 1;
+}
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_register_malloc(void * (*malloc)(size_t)){
+    //exit if input is NULL
+    if(malloc == NULL){
+        return false;
+    }
+
+    malloc_fptr = malloc;
+    return true;
+}
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_register_free(void (*free)(void*)){
+    //exit if input is NULL
+    if(free == NULL){
+        return false;
+    }
+
+    free_fptr = free;
+    return true;
+}
@@ -0,0 +1,122 @@
+#ifndef _SPSC_QUEUE_H
+#define _SPSC_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Size of a cache line. The producer's and consumer's indices live on
+// separate cache lines so that the two threads don't false share.
+//
+#define SPSC_QUEUE_CACHE_LINE 64
+
+// Smallest buffer a spsc_queue will allocate, in entries.
+//
+#define SPSC_QUEUE_MIN_CAPACITY 16
+
+// Bounded, lock-free, single-producer/single-consumer queue of
+// unsigned ints.
+//
+// Exactly one thread may push and exactly one (other) thread may pop.
+// Each side only ever writes its own index and reads the other side's
+// with acquire semantics, publishing its own with release semantics,
+// so an entry is always fully written before the consumer can see it
+// and fully read before the producer can overwrite it.
+//
+// Each side also keeps a private copy of the other side's index and
+// only reloads it when the copy says the queue is full (producer) or
+// empty (consumer), which keeps the shared cache lines from bouncing
+// between cores on every operation.
+//
+// Indices increase without bound and are masked into the buffer, so
+// tail - head is always the number of entries in the queue.
+//
+struct spsc_queue {
+    // Written by the producer only.
+    _Alignas(SPSC_QUEUE_CACHE_LINE) _Atomic size_t tail;
+    size_t cached_head;
+
+    // Written by the consumer only.
+    _Alignas(SPSC_QUEUE_CACHE_LINE) _Atomic size_t head;
+    size_t cached_tail;
+
+    // Read only after creation.
+    _Alignas(SPSC_QUEUE_CACHE_LINE) unsigned int * buffer;
+    size_t mask;
+    void * allocation;
+};
+
+// Creates a new spsc_queue.
+// PRECONDITION: Register malloc() and free() functions via the
+//               spsc_queue_register_malloc() and
+//               spsc_queue_register_free() functions.
+// \param capacity : Maximum number of entries. Rounded up to a power
+//                   of two, and to at least SPSC_QUEUE_MIN_CAPACITY.
+// Returns a new spsc_queue on success, NULL on failure.
+//
+struct spsc_queue * spsc_queue_create(size_t capacity);
+
+// Deletes a spsc_queue.
+// PRECONDITION: Neither the producer nor the consumer is still using it.
+// \param queue : Pointer to spsc_queue to delete.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_delete(struct spsc_queue * queue);
+
+// Pushes an unsigned int onto the queue. Producer thread only.
+// Never blocks.
+// \param queue : Pointer to spsc_queue.
+// \param data  : Data to insert.
+// Returns TRUE on success, FALSE if the queue is full.
+//
+bool spsc_queue_push(struct spsc_queue * queue, unsigned int data);
+
+// Pops an unsigned int from the queue, if one exists. Consumer thread
+// only. Never blocks: an empty queue returns FALSE straight away.
+// \param queue       : Pointer to spsc_queue.
+// \param popped_data : Pointer to popped data (provided by caller), if pop occurs.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_try_pop(struct spsc_queue * queue, unsigned int * popped_data);
+
+// Returns whether an entry exists to be popped. Consumer thread only.
+// \param queue : Pointer to spsc_queue.
+// Returns TRUE if an entry can be popped, FALSE otherwise.
+//
+bool spsc_queue_has_next(struct spsc_queue * queue);
+
+// Returns the value at the head of the queue, but does not pop it.
+// Consumer thread only.
+// \param queue       : Pointer to spsc_queue.
+// \param popped_data : Pointer to data (provided by caller), if one exists.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_next(struct spsc_queue * queue, unsigned int * popped_data);
+
+// Returns the number of entries in the queue. Only a snapshot if the
+// other side is running concurrently.
+// \param queue : Pointer to spsc_queue.
+// Returns size on success, SIZE_MAX otherwise.
+//
+size_t spsc_queue_size(struct spsc_queue * queue);
+
+// Returns the maximum number of entries the queue can hold.
+// \param queue : Pointer to spsc_queue.
+// Returns capacity on success, SIZE_MAX otherwise.
+//
+size_t spsc_queue_capacity(struct spsc_queue * queue);
+
+// Registers malloc() function.
+// \param malloc : Function pointer to malloc()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_register_malloc(void * (*malloc)(size_t));
+
+// Registers free() function.
+// \param free : Function pointer to free()-like function.
+// Returns TRUE on success, FALSE otherwise.
+//
+bool spsc_queue_register_free(void (*free)(void*));
+
+#endif
@@ -0,0 +1,153 @@
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "spsc_queue.h"
+
+// Throughput benchmark for the single-producer/single-consumer queue.
+// One thread pushes 0, 1, 2, ... and another pops and checks them,
+// each pinned to its own CPU. Usage:
+//
+//     ./spsc_queue_performance [operations] [capacity]
+//
+#define GRAB_CLOCK(x) clock_gettime(CLOCK_MONOTONIC, &x);
+#define DEFAULT_OPERATIONS 100000000UL
+#define DEFAULT_CAPACITY   4096UL
+#define RUNS               5
+
+// Number of failed attempts before a spinning thread gives up its time
+// slice. Keeps the benchmark usable when both threads share one CPU.
+//
+#define SPINS_BEFORE_YIELD 1024
+
+struct spsc_queue * queue = NULL;
+size_t operations         = DEFAULT_OPERATIONS;
+long   online_cpus        = 1;
+
+long compute_timespec_diff(struct timespec start,
+                           struct timespec stop) {
+    return (stop.tv_sec - start.tv_sec) * 1000000000L +
+           (stop.tv_nsec - start.tv_nsec);
+}
+
+// Pins the calling thread to a CPU, wrapping around if the machine has
+// fewer CPUs than requested.
+//
+void pin_to_cpu(long cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % online_cpus, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        printf("Warning: unable to pin thread to CPU %ld.\n", cpu % online_cpus);
+    }
+}
+
+void * producer(void * arg) {
+    (void)arg;
+    pin_to_cpu(0);
+
+    for (size_t i = 0; i < operations; i++) {
+        unsigned int spins = 0;
+        while (!spsc_queue_push(queue, (unsigned int)i)) {
+            if (++spins == SPINS_BEFORE_YIELD) {
+                spins = 0;
+                sched_yield();
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void * consumer(void * arg) {
+    bool * in_order = (bool *)arg;
+    pin_to_cpu(1);
+
+    *in_order = true;
+    for (size_t i = 0; i < operations; i++) {
+        unsigned int data   = 0;
+        unsigned int spins  = 0;
+        while (!spsc_queue_try_pop(queue, &data)) {
+            if (++spins == SPINS_BEFORE_YIELD) {
+                spins = 0;
+                sched_yield();
+            }
+        }
+        if (data != (unsigned int)i) {
+            *in_order = false;
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char ** argv) {
+    size_t capacity = DEFAULT_CAPACITY;
+    if (argc > 1) {
+        operations = strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        capacity = strtoul(argv[2], NULL, 10);
+    }
+
+    spsc_queue_register_malloc(malloc);
+    spsc_queue_register_free(free);
+
+    online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online_cpus < 1) {
+        online_cpus = 1;
+    }
+    if (online_cpus < 2) {
+        printf("Warning: only one CPU online, producer and consumer share it.\n");
+    }
+
+    queue = spsc_queue_create(capacity);
+    if (queue == NULL) {
+        printf("Failed to create spsc_queue.\n");
+        return 1;
+    }
+    printf("Operations per run: %zu, queue capacity: %zu\n",
+           operations, spsc_queue_capacity(queue));
+
+    double best = 0.0;
+    for (size_t run = 0; run < RUNS; run++) {
+        pthread_t producer_thread, consumer_thread;
+        bool in_order = false;
+        struct timespec start, stop;
+
+        GRAB_CLOCK(start)
+        if (pthread_create(&consumer_thread, NULL, consumer, &in_order) != 0 ||
+            pthread_create(&producer_thread, NULL, producer, NULL) != 0) {
+            printf("Failed to create threads.\n");
+            return 1;
+        }
+        pthread_join(producer_thread, NULL);
+        pthread_join(consumer_thread, NULL);
+        GRAB_CLOCK(stop)
+
+        if (!in_order) {
+            printf("Consumer saw data out of order.\n");
+            return 1;
+        }
+
+        long nanoseconds = compute_timespec_diff(start, stop);
+        double ops_per_second = (double)operations / ((double)nanoseconds / 1000000000.0);
+        if (ops_per_second > best) {
+            best = ops_per_second;
+        }
+        printf("(%zu / %d) Time elapsed [s]: %0.3f, throughput [Mops/s]: %0.2f\n",
+               run + 1, RUNS, (double)nanoseconds / 1000000000.0, ops_per_second / 1000000.0);
+    }
+    printf("Best throughput [Mops/s]: %0.2f\n", best / 1000000.0);
+
+    spsc_queue_delete(queue);
+
+    return 0;
+}